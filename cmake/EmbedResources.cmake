@@ -0,0 +1,32 @@
+# Generates a C++ source file with every file from RESOURCE_DIR embedded as a byte array.
+# The generated table is described by src/gui/embedded.h.
+#
+# Usage: cmake -DRESOURCE_DIR=<dir> -DOUTPUT=<file.cpp> -P EmbedResources.cmake
+
+file(GLOB RESOURCE_FILES RELATIVE "${RESOURCE_DIR}" "${RESOURCE_DIR}/*")
+list(SORT RESOURCE_FILES)
+
+# CMake regular expressions do not support repetition counts
+string(REPEAT "0x[0-9a-f][0-9a-f]," 16 LINE_PATTERN)
+
+set(CONTENT "// Generated by cmake/EmbedResources.cmake - do not edit\n\n#include \"embedded.h\"\n\n\nnamespace GUI {\n\n")
+set(TABLE "")
+set(INDEX 0)
+
+foreach(NAME IN LISTS RESOURCE_FILES)
+    file(READ "${RESOURCE_DIR}/${NAME}" HEX_DATA HEX)
+    file(SIZE "${RESOURCE_DIR}/${NAME}" DATA_SIZE)
+
+    # Emit 16 bytes per line to keep the generated file readable for the compiler diagnostics
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX_DATA}")
+    string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n        " BYTES "${BYTES}")
+
+    string(APPEND CONTENT "    static const unsigned char RESOURCE_${INDEX}[] = {\n        ${BYTES}\n    };\n\n")
+    string(APPEND TABLE "        { \"${NAME}\", RESOURCE_${INDEX}, ${DATA_SIZE} },\n")
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+string(APPEND CONTENT "    const EmbeddedFile EMBEDDED_FILES[] = {\n${TABLE}    };\n\n")
+string(APPEND CONTENT "    const std::size_t EMBEDDED_FILE_COUNT = ${INDEX};\n\n}\n")
+
+file(WRITE "${OUTPUT}" "${CONTENT}")
@@ -2,17 +2,30 @@
 #include "src/logic/solver.h"
 #include "src/gui/controller.h"
 #include <chrono>
+#include <iostream>
 #include <memory>
+#include <string>
 
 using namespace Sudoku;
 
 
-int main()
+int main(int argc, char** argv)
 {
+    // Optional startup time report
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--startup-times") {
+            GUI::set_startup_hook([](const std::string& phase, std::chrono::microseconds sinceStart) {
+                std::clog << "[startup] " << phase << ": " << sinceStart.count() / 1000.0 << " ms" << std::endl;
+            });
+        }
+    }
+
     GUI::load_resources();
+    GUI::mark_startup_phase("resources loaded");
 
     std::unique_ptr<GUI::Controller> controller = std::make_unique<GUI::Controller>();
+    GUI::mark_startup_phase("controller created");
     controller->run();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../logic/board.h"
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+// --------------
+// Shared corpora
+// --------------
+
+// Well-known 9x9 puzzles which are hard for backtracking search
+constexpr const char* HARD_PUZZLES[] = {
+    "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..",
+    "..............3.85..1.2.......5.7.....4...1...9.......5......73..2.1........4...9",
+    "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+    "52...6.........7.13...........4..8..6......5...........418.........3..2...87.....",
+    "6.....8.3.4.7.................5.4.7.3..2.....1.6.......2.....5.....8.6......1....",
+    "48.3............71.2.......7.5....6....2..8.............1.76...3.....4......5....",
+    "....14....3....2...7..........9...3.6.1.............8.2.....1.4....5.6.....7.8...",
+    "1....7.9..3..2...8..96..5....53..9...1..8...26....4...3......1..4......7..7...3..",
+    ".....6....59.....82....8....45........3........6..3.54...325..6..................",
+};
+
+// True if the board is a correct completion of the puzzle
+inline bool is_solution(const Sudoku::Board& puzzle, const Sudoku::Board& board)
+{
+    for (int cell = 0; cell < Sudoku::CELL_COUNT; cell++) {
+        if (board.isEmpty(cell) || (!puzzle.isEmpty(cell) && puzzle.getNumber(cell) != board.getNumber(cell)))
+            return false;
+    }
+
+    return board.isCorrect();
+}
+
+// Reads puzzles from a file with one puzzle per line (empty lines are skipped)
+// Lines without exactly one symbol for every field are rejected, with their numbers in the exception message
+inline std::vector<Sudoku::Board> read_puzzles(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("cannot open " + path);
+
+    std::vector<Sudoku::Board> puzzles;
+    std::string malformed;
+    int lineNumber = 0, malformedCount = 0;
+    for (std::string line; std::getline(file, line);) {
+        lineNumber++;
+        if (line.empty())
+            continue;
+        if (Sudoku::field_symbol_count(line) != Sudoku::CELL_COUNT) {
+            if (malformedCount++ < 10)
+                malformed += (malformed.empty() ? "" : ", ") + std::to_string(lineNumber);
+            continue;
+        }
+        puzzles.emplace_back();
+        puzzles.back().load(line);
+    }
+
+    if (malformedCount > 0)
+        throw std::runtime_error(path + ": " + std::to_string(malformedCount) + " malformed puzzles, on lines " + malformed +
+                                 (malformedCount > 10 ? ", ..." : ""));
+    return puzzles;
+}
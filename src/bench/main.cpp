@@ -0,0 +1,530 @@
+#include "corpus.h"
+#include "../logic/allocationCounter.h"
+#include "../logic/generators.h"
+#include "../logic/laneSolver.h"
+#include "../logic/latency.h"
+#include "../logic/satSolver.h"
+#include "../logic/solutionEnumerator.h"
+#include "../logic/traceSpans.h"
+#include "../logic/validation.h"
+#include "../logic/variantSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Sudoku;
+
+
+// --------------
+// Helper defines
+// --------------
+
+// Bigger boards are benchmarked by the dedicated builds (sudoku-bench-16, sudoku-bench-25)
+constexpr bool LARGE_BOARD = BOARD_SIZE > 9;
+
+constexpr std::size_t DEFAULT_PUZZLE_COUNT = BOARD_SIZE == 9 ? 20000 : BOARD_SIZE == 16 ? 1000 : 100;
+constexpr long SEARCH_BACKTRACK_LIMIT = LARGE_BOARD ? 20000 : 0;   // The search gives up some of the bigger puzzles, the SAT backend never
+constexpr std::size_t VARIANT_SET_RATIO = 20;       // Every variant set has count / VARIANT_SET_RATIO puzzles (9x9 boards only)
+constexpr int VARIANT_REMOVED_CELLS = 55;
+constexpr int KILLER_REMOVED_CELLS = 75;
+constexpr std::size_t VALIDATION_CELLS = 1 << 24;   // Cells checked by every validation method (the solutions are repeated)
+constexpr std::uint64_t STREAMED_SOLUTIONS = BOARD_SIZE == 9 ? 1000000 : BOARD_SIZE == 16 ? 100000 : 10000;   // Completions of the empty board
+constexpr std::uint64_t SKIP_WINDOW = 100;          // Solutions compared after a skip-ahead
+
+struct Measurement
+{
+    double seconds;
+    LatencyHistogram::Summary latency;      // Latencies of single puzzles, if the method measures them
+    std::size_t solved;
+};
+
+// Solves the puzzles in place with the given method and returns the number of solved ones
+using SolveMethod = std::function<std::size_t(std::vector<Board>& boards, LatencyHistogram& latencies)>;
+
+// Latency summaries of all the measured methods, exported with --latency
+using LatencyReport = std::vector<std::pair<std::string, LatencyHistogram::Summary>>;
+
+
+// ----------------
+// Helper functions
+// ----------------
+
+void print_usage()
+{
+    std::cerr << "Usage: sudoku-bench [--count <n>] [--seed <n>] [--file <path>] [--latency <path>] [--trace <path>]\n"
+                 "Compares the throughput of the available solving methods on generated puzzles\n"
+                 "or on puzzles from the given file (one per line).\n"
+                 "--seed reproduces the generated puzzles of an earlier run (its seed is printed)\n"
+                 "--latency exports the latency percentiles and histograms of the methods as JSON\n"
+                 "--trace records the solver and generator phases as a Chrome trace (slows the methods down)\n";
+}
+
+// Same seed gives the same puzzles, regardless of the number of threads
+std::vector<Board> generate_puzzles(std::size_t count, std::uint64_t seed)
+{
+    ThreadPool pool;
+    std::vector<Board> puzzles(count);
+    generate_positions(puzzles, seed, pool);
+
+    return puzzles;
+}
+
+Measurement measure(const std::vector<Board>& puzzles, const SolveMethod& method, std::vector<Board>& solutions)
+{
+    solutions = puzzles;
+
+    LatencyHistogram latencies(puzzles.size());
+    auto start = LatencyClock::now();
+    std::size_t solved = method(solutions, latencies);
+    std::chrono::duration<double> elapsed = LatencyClock::now() - start;
+
+    return { elapsed.count(), latencies.summary(), solved };
+}
+
+// Solves the puzzles one by one, measuring every one of them
+SolveMethod one_by_one(Solver& solver, long& allocations)
+{
+    return [&solver, &allocations](std::vector<Board>& boards, LatencyHistogram& latencies) {
+        std::size_t solved = 0;
+        for (Board& board : boards) {
+            auto start = LatencyClock::now();
+            solved += solver.solve(board);
+            latencies.record(LatencyClock::now() - start);
+            allocations += solver.getStats().allocations;
+        }
+        return solved;
+    };
+}
+
+// Variant puzzle together with a solver for its rules (the rules may differ between the puzzles)
+template <typename VariantSolverType>
+struct VariantPuzzle
+{
+    VariantSolverType solver;
+    Board puzzle;
+};
+
+void remove_cells(Board& board, int count, RandomStream& randomGen)
+{
+    std::array<int, CELL_COUNT> cells;
+    for (int cell = 0; cell < CELL_COUNT; cell++)
+        cells[cell] = cell;
+    randomGen.shuffle(cells.begin(), cells.end());
+
+    for (int i = 0; i < count; i++)
+        board.setNumber(cells[i], 0);
+}
+
+// Solved sudoku-X boards are obtained by solving boards with a random permutation on the main diagonal
+std::vector<VariantPuzzle<DiagonalSolver>> generate_diagonal_puzzles(std::size_t count, RandomStream& randomGen)
+{
+    std::vector<VariantPuzzle<DiagonalSolver>> puzzles;
+    std::array<int, BOARD_SIZE> diagonal;
+    for (int i = 0; i < BOARD_SIZE; i++)
+        diagonal[i] = i + 1;
+
+    while (puzzles.size() < count) {
+        randomGen.shuffle(diagonal.begin(), diagonal.end());
+
+        VariantPuzzle<DiagonalSolver>& entry = puzzles.emplace_back();
+        for (int i = 0; i < BOARD_SIZE; i++)
+            entry.puzzle.setNumber(i, i, diagonal[i]);
+        if (!entry.solver.solve(entry.puzzle)) {
+            puzzles.pop_back();
+            continue;
+        }
+        remove_cells(entry.puzzle, VARIANT_REMOVED_CELLS, randomGen);
+    }
+
+    return puzzles;
+}
+
+// Jigsaw and killer puzzles are derived from solved classic boards
+std::vector<VariantPuzzle<JigsawSolver>> generate_jigsaw_puzzles(const std::vector<Board>& solutions, RandomStream& randomGen)
+{
+    std::vector<VariantPuzzle<JigsawSolver>> puzzles;
+    for (const Board& solution : solutions) {
+        puzzles.push_back({ JigsawSolver(random_jigsaw_regions(solution, randomGen)), solution });
+        remove_cells(puzzles.back().puzzle, VARIANT_REMOVED_CELLS, randomGen);
+    }
+
+    return puzzles;
+}
+
+std::vector<VariantPuzzle<KillerSolver>> generate_killer_puzzles(const std::vector<Board>& solutions, RandomStream& randomGen)
+{
+    std::vector<VariantPuzzle<KillerSolver>> puzzles;
+    for (const Board& solution : solutions) {
+        puzzles.push_back({ KillerSolver(StandardBoxes(), random_killer_cages(solution, randomGen)), solution });
+        remove_cells(puzzles.back().puzzle, KILLER_REMOVED_CELLS, randomGen);
+    }
+
+    return puzzles;
+}
+
+// Solves every puzzle with its own solver; unsolved puzzles and rule violations are counted as errors
+template <typename VariantSolverType>
+Measurement measure_variant(std::vector<VariantPuzzle<VariantSolverType>>& puzzles, std::size_t& errors)
+{
+    Measurement result = { 0.0, {}, 0 };
+    LatencyHistogram latencies(puzzles.size());
+    for (auto& [solver, puzzle] : puzzles) {
+        Board board = puzzle;
+        auto start = LatencyClock::now();
+        bool solved = solver.solve(board);
+        std::chrono::duration<double> elapsed = LatencyClock::now() - start;
+
+        result.seconds += elapsed.count();
+        latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+        result.solved += solved;
+
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            solved &= puzzle.isEmpty(cell) || puzzle.getNumber(cell) == board.getNumber(cell);
+        errors += !(solved && solver.isSolution(board));
+    }
+
+    result.latency = latencies.summary();
+    return result;
+}
+
+void print_measurement(const std::string& name, const Measurement& result, std::size_t puzzles, double baseline, LatencyReport& report)
+{
+    std::cout << std::left << std::setw(24) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3) << result.seconds << " s"
+              << std::setw(14) << std::setprecision(0) << puzzles / result.seconds << " puzzles/s"
+              << std::setw(8) << std::setprecision(2) << baseline / result.seconds << "x"
+              << std::setw(10) << result.solved << " solved";
+    if (result.latency.samples > 0) {
+        std::cout << "   p50 " << std::setw(9) << format_latency(result.latency.p50) << "   p99 " << std::setw(9) << format_latency(result.latency.p99)
+                  << "   max " << std::setw(9) << format_latency(result.latency.max);
+        report.emplace_back(name, result.latency);
+    }
+    std::cout << "\n";
+}
+
+
+// Runs every method on the puzzles, the first one being the baseline for the others
+// Returns false if the methods do not solve the same puzzles (they may find different solutions, though)
+// or, with bounded methods, if any of them solves a puzzle not solved by the baseline
+// Latencies are reported with the names prefixed by the name of the set (if any)
+bool compare_methods(const std::vector<Board>& puzzles, const std::vector<std::pair<std::string, SolveMethod>>& methods,
+                     LatencyReport& report, const std::string& setName = "", bool bounded = false)
+{
+    std::vector<bool> expected;
+    double baseline = 0.0;
+    bool consistent = true;
+    for (const auto& [name, method] : methods) {
+        std::vector<Board> solutions;
+        Measurement result = measure(puzzles, method, solutions);
+        if (baseline == 0.0)
+            baseline = result.seconds;
+        print_measurement(setName.empty() ? name : setName + "/" + name, result, puzzles.size(), baseline, report);
+
+        for (std::size_t i = 0; i < puzzles.size(); i++) {
+            bool solved = is_solution(puzzles[i], solutions[i]);
+            if (expected.size() < puzzles.size())
+                expected.push_back(solved);
+            consistent &= bounded ? !solved || expected[i] : solved == expected[i];
+        }
+    }
+
+    return consistent;
+}
+
+// Checks copies of the solutions, every other one with a single field changed, both one by one (Board::isCorrect()
+// and a scan for empty fields) and with the bulk validator. Returns false if the results differ.
+bool compare_validation(const std::vector<Board>& solutions)
+{
+    std::size_t count = std::max<std::size_t>(VALIDATION_CELLS / CELL_COUNT, solutions.size());
+    std::vector<Board> boards(count);
+    std::vector<std::uint8_t> grids(count * CELL_COUNT);
+    for (std::size_t i = 0; i < count; i++) {
+        boards[i] = solutions[i % solutions.size()];
+        if (i % 2 == 1) {
+            int cell = static_cast<int>(i / 2 % CELL_COUNT);
+            boards[i].setNumber(cell, boards[i].getNumber(cell) % BOARD_SIZE + 1);
+        }
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            grids[i * CELL_COUNT + cell] = static_cast<std::uint8_t>(boards[i].getNumber(cell));
+    }
+
+    auto start = LatencyClock::now();
+    std::vector<bool> expected(count);
+    for (std::size_t i = 0; i < count; i++) {
+        bool full = true;
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            full &= !boards[i].isEmpty(cell);
+        expected[i] = full && boards[i].isCorrect();
+    }
+    std::chrono::duration<double> scalar = LatencyClock::now() - start;
+
+    auto valid = std::make_unique<bool[]>(count);
+    start = LatencyClock::now();
+    validate_grids(grids, std::span<bool>(valid.get(), count));
+    std::chrono::duration<double> bulk = LatencyClock::now() - start;
+
+    bool consistent = true;
+    for (std::size_t i = 0; i < count; i++)
+        consistent &= valid[i] == expected[i];
+
+    for (const auto& [name, seconds] : { std::pair{ "validate/scalar", scalar.count() }, std::pair{ "validate/bulk", bulk.count() } }) {
+        std::cout << std::left << std::setw(24) << name << std::right
+                  << std::setw(10) << std::fixed << std::setprecision(3) << seconds << " s"
+                  << std::setw(14) << std::setprecision(0) << count * CELL_COUNT / seconds << " cells/s"
+                  << std::setw(10) << std::setprecision(2) << scalar.count() / seconds << "x\n";
+    }
+
+    return consistent;
+}
+
+// Streams completions of the empty board, checking that each one is correct and that a skip-ahead to the second half
+// gives the same solutions as the full stream. Returns false on any mismatch.
+bool stream_completions()
+{
+    SolutionEnumerator enumerator;
+    Board empty;
+    std::uint64_t skip = STREAMED_SOLUTIONS / 2, index = 0;
+    std::vector<Board> window;
+    bool consistent = true;
+
+    auto start = LatencyClock::now();
+    for (const Board& solution : enumerator.solutions(empty, 0, STREAMED_SOLUTIONS)) {
+        if (index % 1024 == 0)
+            consistent &= solution.isCorrect();
+        if (index >= skip && index < skip + SKIP_WINDOW)
+            window.push_back(solution);
+        index++;
+    }
+    std::chrono::duration<double> elapsed = LatencyClock::now() - start;
+    SolutionEnumerator::Stats stats = enumerator.getStats();
+
+    index = 0;
+    for (const Board& solution : enumerator.solutions(empty, skip, SKIP_WINDOW))
+        consistent &= index < window.size() && solution == window[index++];
+    consistent &= index == window.size() && stats.yielded == STREAMED_SOLUTIONS;
+
+    std::cout << std::left << std::setw(24) << "enumerate/empty" << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3) << elapsed.count() << " s"
+              << std::setw(14) << std::setprecision(0) << stats.yielded / elapsed.count() << " solutions/s"
+              << "    " << stats.guesses << " guesses, depth " << stats.maxDepth << "\n";
+
+    return consistent;
+}
+
+// ----------
+// Benchmarks
+// ----------
+
+int main(int argc, char** argv)
+{
+    std::size_t count = DEFAULT_PUZZLE_COUNT;
+    std::uint64_t seed = random_seed();
+    std::string path, latencyPath, tracePath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--count" && i + 1 < argc)
+            count = static_cast<std::size_t>(std::atol(argv[++i]));
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--file" && i + 1 < argc)
+            path = argv[++i];
+        else if (arg == "--latency" && i + 1 < argc)
+            latencyPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else {
+            print_usage();
+            return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    set_span_tracing(!tracePath.empty());
+    name_trace_thread("main");
+
+    std::vector<Board> puzzles;
+    try {
+        puzzles = path.empty() ? generate_puzzles(count, seed) : read_puzzles(path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "sudoku-bench: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Solver solver;
+    LaneSolver laneSolver(&solver);
+    VariantSolver<StandardBoxes> classicSolver;
+    SatSolver satSolver;
+    long solverAllocations = 0;
+    solver.setBacktrackLimit(SEARCH_BACKTRACK_LIMIT);
+
+    SolveMethod satMethod = [&satSolver](std::vector<Board>& boards, LatencyHistogram& latencies) {
+        std::size_t solved = 0;
+        for (Board& board : boards) {
+            auto start = LatencyClock::now();
+            solved += satSolver.solve(board);
+            latencies.record(LatencyClock::now() - start);
+        }
+        return solved;
+    };
+
+    // The first method is the baseline for the others - the SAT backend on the bigger boards, where the search is bounded
+    std::vector<std::pair<std::string, SolveMethod>> methods;
+    if (LARGE_BOARD)
+        methods.emplace_back("sat", satMethod);
+    methods.emplace_back("scalar", one_by_one(solver, solverAllocations));
+    methods.emplace_back("lanes", [&laneSolver](std::vector<Board>& boards, LatencyHistogram&) {
+        auto solved = std::make_unique<bool[]>(boards.size());
+        return laneSolver.solve(boards, std::span<bool>(solved.get(), boards.size()));
+    });
+    if (!LARGE_BOARD) {
+        methods.emplace_back("variant/classic", [&classicSolver](std::vector<Board>& boards, LatencyHistogram& latencies) {
+            std::size_t solved = 0;
+            for (Board& board : boards) {
+                auto start = LatencyClock::now();
+                solved += classicSolver.solve(board);
+                latencies.record(LatencyClock::now() - start);
+            }
+            return solved;
+        });
+        methods.emplace_back("sat", satMethod);
+    }
+
+    // Scalar solver with each of the branching heuristics
+    std::vector<std::unique_ptr<BranchingHeuristic>> heuristics;
+    std::vector<std::unique_ptr<Solver>> heuristicSolvers;
+    for (HeuristicType type : { HeuristicType::MRV, HeuristicType::MRV_DEGREE, HeuristicType::LCV,
+                                HeuristicType::RANDOM_RESTARTS, HeuristicType::ADAPTIVE }) {
+        heuristics.push_back(make_heuristic(type));
+        heuristicSolvers.push_back(std::make_unique<Solver>());
+        heuristicSolvers.back()->setHeuristic(heuristics.back().get());
+        heuristicSolvers.back()->setBacktrackLimit(SEARCH_BACKTRACK_LIMIT);
+        methods.emplace_back(std::string("scalar/") + heuristic_name(type), one_by_one(*heuristicSolvers.back(), solverAllocations));
+    }
+
+    std::cout << BOARD_SIZE << "x" << BOARD_SIZE << " boards, " << puzzles.size() << " puzzles, seed " << seed << "\n";
+    LatencyReport latencyReport;
+    bool consistent = compare_methods(puzzles, methods, latencyReport, "", LARGE_BOARD);
+
+    const LaneSolver::Stats& stats = laneSolver.getStats();
+    std::cout << "lanes: " << stats.propagated << " finished by propagation, " << stats.handedOff << " handed off\n";
+
+    // Hard set, where the search strategy matters more than the raw speed
+    // On the bigger boards it consists of the puzzles abandoned by the search
+    std::vector<Board> hardPuzzles;
+    if (LARGE_BOARD) {
+        for (const Board& puzzle : puzzles) {
+            Board board = puzzle;
+            if (!solver.solve(board) && solver.getStats().abandoned)
+                hardPuzzles.push_back(puzzle);
+        }
+    }
+    else {
+        for (const char* setup : HARD_PUZZLES) {
+            hardPuzzles.emplace_back();
+            hardPuzzles.back().load(setup);
+        }
+    }
+
+    std::cout << hardPuzzles.size() << " hard puzzles\n";
+    if (hardPuzzles.empty()) {
+        std::cerr << "sudoku-bench: warning - the search abandoned none of the " << puzzles.size() << " puzzles, so the hard set "
+                     "is empty and its comparison is skipped (try a bigger --count, or a --file with harder puzzles)" << std::endl;
+    }
+    else if (LARGE_BOARD)
+        consistent &= compare_methods(hardPuzzles, { { "sat", satMethod }, { "scalar", one_by_one(solver, solverAllocations) } },
+                                      latencyReport, "hard", true);
+    else if (!LARGE_BOARD)
+        consistent &= compare_methods(hardPuzzles, { { "scalar", one_by_one(solver, solverAllocations) }, { "sat", satMethod } },
+                                      latencyReport, "hard");
+
+    // Variant sets, built from the solutions of the classic ones
+    std::size_t variantErrors = 0;
+    if (!LARGE_BOARD) {
+        std::vector<Board> classicSolutions;
+        for (const Board& puzzle : puzzles) {
+            if (classicSolutions.size() == std::max<std::size_t>(puzzles.size() / VARIANT_SET_RATIO, 1))
+                break;
+            Board board = puzzle;
+            if (solver.solve(board))
+                classicSolutions.push_back(board);
+        }
+
+        RandomStream randomGen(seed + 1);      // Separate from the streams of the classic puzzles
+        auto diagonalPuzzles = generate_diagonal_puzzles(classicSolutions.size(), randomGen);
+        auto jigsawPuzzles = generate_jigsaw_puzzles(classicSolutions, randomGen);
+        auto killerPuzzles = generate_killer_puzzles(classicSolutions, randomGen);
+
+        std::cout << classicSolutions.size() << " puzzles of every variant\n";
+        Measurement diagonal = measure_variant(diagonalPuzzles, variantErrors);
+        print_measurement("variant/x", diagonal, diagonalPuzzles.size(), diagonal.seconds, latencyReport);
+        print_measurement("variant/jigsaw", measure_variant(jigsawPuzzles, variantErrors), jigsawPuzzles.size(), diagonal.seconds, latencyReport);
+        print_measurement("variant/killer", measure_variant(killerPuzzles, variantErrors), killerPuzzles.size(), diagonal.seconds, latencyReport);
+    }
+
+    // Bulk validation of completed grids
+    std::vector<Board> solvedBoards;
+    for (const Board& puzzle : puzzles) {
+        Board board = puzzle;
+        if (solver.solve(board))
+            solvedBoards.push_back(board);
+    }
+    if (!solvedBoards.empty() && !compare_validation(solvedBoards)) {
+        std::cerr << "sudoku-bench: validation methods disagree" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Lazy enumeration of many solutions
+    if (!stream_completions()) {
+        std::cerr << "sudoku-bench: enumerated solutions are wrong or inconsistent" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Span trace of the whole run, including the generation of the puzzles
+    if (!tracePath.empty() && !write_span_trace(tracePath)) {
+        std::cerr << "sudoku-bench: cannot write " << tracePath << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Latency export - a JSON object with the summary of every method measuring single puzzles
+    if (!latencyPath.empty()) {
+        std::ofstream output(latencyPath);
+        output << "{";
+        for (std::size_t i = 0; i < latencyReport.size(); i++)
+            output << (i > 0 ? ",\n\"" : "\n\"") << latencyReport[i].first << "\":" << latency_json(latencyReport[i].second);
+        output << "\n}\n";
+        if (!output) {
+            std::cerr << "sudoku-bench: cannot write " << latencyPath << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!consistent) {
+        std::cerr << "sudoku-bench: solving methods disagree" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Generated variant puzzles always have a solution
+    if (variantErrors != 0) {
+        std::cerr << "sudoku-bench: " << variantErrors << " variant puzzles not solved correctly" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The search is meant to be allocation-free (the recorded spans are not)
+    if (ALLOCATION_COUNTING && tracePath.empty()) {
+        std::cout << "scalar: " << solverAllocations << " heap allocations\n";
+        if (solverAllocations != 0) {
+            std::cerr << "sudoku-bench: solver performed heap allocations" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,353 @@
+#include "sudoku.h"
+#include "../logic/laneSolver.h"
+#include "../logic/satSolver.h"
+#include "../logic/threadPool.h"
+#include "../logic/validation.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace {
+
+    using namespace Sudoku;
+
+    // Customizable parameters
+    constexpr std::size_t CHUNKS_PER_WORKER = 4;
+    constexpr std::size_t GROUP_SIZE = LaneSolver::LANES;
+    constexpr std::size_t VALIDATION_GROUP_SIZE = 1024;   // Grids validated by a single work item
+    constexpr std::size_t MIN_CHUNK_SIZE = 8;       // Smaller batches (of items or puzzle groups) are processed on the calling thread
+    constexpr bool USE_SAT_BACKEND = BOARD_SIZE > 9;    // The search explodes on some of the bigger puzzles
+
+    static_assert(SUDOKU_CELLS == CELL_COUNT, "SUDOKU_BOX_SIZE of the C interface has to match the one of the solver");
+
+
+    // --------------------
+    // Board buffer helpers
+    // --------------------
+
+    bool read_board(const std::uint8_t* cells, Board& board)
+    {
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++) {
+                std::uint8_t value = cells[r * BOARD_SIZE + c];
+                if (value > BOARD_SIZE)
+                    return false;
+                board.setNumber(r, c, value);
+            }
+        }
+
+        return true;
+    }
+
+    void write_board(const Board& board, std::uint8_t* cells)
+    {
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++)
+                cells[r * BOARD_SIZE + c] = static_cast<std::uint8_t>(board.getNumber(r, c));
+        }
+    }
+
+    // Solver instances used by a single thread
+    struct WorkerContext
+    {
+        Solver solver;
+        LaneSolver laneSolver;
+        SatSolver satSolver;
+
+        WorkerContext() : laneSolver(&solver) {}
+    };
+
+    template <typename AnySolver>
+    int solve_puzzle(AnySolver& solver, const std::uint8_t* in, std::uint8_t* out)
+    {
+        Board board;
+        if (!read_board(in, board)) {
+            std::copy(in, in + SUDOKU_CELLS, out);
+            return SUDOKU_INVALID;
+        }
+
+        if (!solver.solve(board)) {
+            std::copy(in, in + SUDOKU_CELLS, out);
+            return SUDOKU_UNSOLVABLE;
+        }
+
+        write_board(board, out);
+        return SUDOKU_SOLVED;
+    }
+
+    // Solves up to LaneSolver::LANES consecutive puzzles at once
+    void solve_group(LaneSolver& laneSolver, const std::uint8_t* in, std::uint8_t* out, std::size_t count,
+                     std::int8_t* status)
+    {
+        std::array<Board, LaneSolver::LANES> boards;
+        std::array<std::size_t, LaneSolver::LANES> indexes;
+        std::array<bool, LaneSolver::LANES> solved;
+
+        // Invalid puzzles do not take up lanes
+        std::size_t lanes = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            if (read_board(in + i * SUDOKU_CELLS, boards[lanes]))
+                indexes[lanes++] = i;
+            else {
+                status[i] = SUDOKU_INVALID;
+                std::copy(in + i * SUDOKU_CELLS, in + (i + 1) * SUDOKU_CELLS, out + i * SUDOKU_CELLS);
+            }
+        }
+
+        laneSolver.solve(std::span<Board>(boards.data(), lanes), solved);
+
+        for (std::size_t lane = 0; lane < lanes; lane++) {
+            std::size_t i = indexes[lane];
+            status[i] = solved[lane] ? SUDOKU_SOLVED : SUDOKU_UNSOLVABLE;
+            if (solved[lane])
+                write_board(boards[lane], out + i * SUDOKU_CELLS);
+            else
+                std::copy(in + i * SUDOKU_CELLS, in + (i + 1) * SUDOKU_CELLS, out + i * SUDOKU_CELLS);
+        }
+    }
+
+
+    // ------------
+    // Engine class
+    // ------------
+
+    // Worker threads with their own solver contexts, shared by all the batch calls.
+    // Batches are split into chunks, while the calling thread waits for all of them to finish.
+    class Engine
+    {
+    public:
+        explicit Engine(unsigned threads) : pool(threads)
+        {
+            for (unsigned i = 0; i < pool.size(); i++)
+                contexts.push_back(std::make_unique<WorkerContext>());
+        }
+
+        // Calls process(context, index) for every index in [0, items)
+        template <typename Process>
+        void forEach(std::size_t items, Process process);
+
+    private:
+        std::vector<std::unique_ptr<WorkerContext>> contexts;
+        ThreadPool pool;        // Declared last, so that workers are stopped before the contexts are destroyed
+    };
+
+    template <typename Process>
+    void Engine::forEach(std::size_t items, Process process)
+    {
+        // Small batches are not worth waking the workers up
+        if (items < MIN_CHUNK_SIZE) {
+            thread_local WorkerContext context;
+            for (std::size_t i = 0; i < items; i++)
+                process(context, i);
+            return;
+        }
+
+        std::size_t chunkSize = std::max(MIN_CHUNK_SIZE, items / (pool.size() * CHUNKS_PER_WORKER));
+        std::size_t chunks = (items + chunkSize - 1) / chunkSize;
+
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::size_t remainingChunks = chunks;
+        std::exception_ptr failure;
+
+        // Chunks refer to the locals above, so the first failure is rethrown only after all the submitted chunks end
+        std::size_t submitted = 0;
+        try {
+            for (; submitted < chunks; submitted++) {
+                pool.submit([&, chunk = submitted](unsigned worker) {
+                    std::exception_ptr chunkFailure;
+                    try {
+                        for (std::size_t i = chunk * chunkSize; i < std::min(items, (chunk + 1) * chunkSize); i++)
+                            process(*contexts[worker], i);
+                    }
+                    catch (...) {
+                        chunkFailure = std::current_exception();
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (chunkFailure && !failure)
+                        failure = chunkFailure;
+                    if (--remainingChunks == 0)
+                        finished.notify_one();
+                });
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            remainingChunks -= chunks - submitted;
+            if (!failure)
+                failure = std::current_exception();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]() { return remainingChunks == 0; });
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+
+
+    // -------------
+    // Engine access
+    // -------------
+
+    std::mutex engineMutex;
+    std::unique_ptr<Engine> engine;
+    unsigned engineThreads = 0;
+
+    Engine& get_engine()
+    {
+        std::lock_guard<std::mutex> lock(engineMutex);
+        if (!engine)
+            engine = std::make_unique<Engine>(engineThreads);
+
+        return *engine;
+    }
+
+    // Exceptions (std::bad_alloc, std::system_error of the threads) must not cross the C interface
+    template <typename Call>
+    auto guarded(Call call) noexcept -> decltype(call())
+    {
+        try {
+            return call();
+        }
+        catch (...) {
+            return SUDOKU_ERROR_RESOURCE;
+        }
+    }
+
+}
+
+
+// -----------
+// C interface
+// -----------
+
+extern "C" {
+
+    int sudoku_api_version(void)
+    {
+        return SUDOKU_API_VERSION;
+    }
+
+    int sudoku_set_thread_count(unsigned threads)
+    {
+        return guarded([&]() -> int {
+            std::lock_guard<std::mutex> lock(engineMutex);
+            if (engine)
+                return SUDOKU_ERROR_STATE;
+
+            engineThreads = threads;
+            return SUDOKU_OK;
+        });
+    }
+
+    int sudoku_board_size(void)
+    {
+        return BOARD_SIZE;
+    }
+
+    int sudoku_solve(const uint8_t* in, uint8_t* out)
+    {
+        return guarded([&]() -> int {
+            if (!in || !out)
+                return SUDOKU_INVALID;
+
+            if constexpr (USE_SAT_BACKEND) {
+                thread_local SatSolver solver;
+                return solve_puzzle(solver, in, out);
+            }
+            else {
+                thread_local Solver solver;
+                return solve_puzzle(solver, in, out);
+            }
+        });
+    }
+
+    ptrdiff_t sudoku_solve_batch(const uint8_t* in, uint8_t* out, size_t n, int8_t* status)
+    {
+        return guarded([&]() -> ptrdiff_t {
+            if (n == 0)
+                return 0;
+            if (!in || !out)
+                return SUDOKU_ERROR_ARGUMENT;
+
+            std::vector<int8_t> ownStatus;
+            if (!status) {
+                ownStatus.resize(n);
+                status = ownStatus.data();
+            }
+
+            if constexpr (USE_SAT_BACKEND) {
+                get_engine().forEach(n, [in, out, status](WorkerContext& context, std::size_t i) {
+                    status[i] = std::int8_t(solve_puzzle(context.satSolver, in + i * SUDOKU_CELLS, out + i * SUDOKU_CELLS));
+                });
+                return std::count(status, status + n, SUDOKU_SOLVED);
+            }
+
+            // Work is distributed in groups of puzzles solved together by the lane solver
+            get_engine().forEach((n + GROUP_SIZE - 1) / GROUP_SIZE, [in, out, n, status](WorkerContext& context, std::size_t group) {
+                std::size_t first = group * GROUP_SIZE;
+                solve_group(context.laneSolver, in + first * SUDOKU_CELLS, out + first * SUDOKU_CELLS,
+                            std::min(GROUP_SIZE, n - first), status + first);
+            });
+
+            return std::count(status, status + n, SUDOKU_SOLVED);
+        });
+    }
+
+    int sudoku_count_batch(const uint8_t* in, size_t n, int limit, int32_t* counts)
+    {
+        return guarded([&]() -> int {
+            if (n == 0)
+                return SUDOKU_OK;
+            if (!in || !counts || limit < 1)
+                return SUDOKU_ERROR_ARGUMENT;
+
+            get_engine().forEach(n, [in, limit, counts](WorkerContext& context, std::size_t i) {
+                Board board;
+                if (!read_board(in + i * SUDOKU_CELLS, board))
+                    counts[i] = SUDOKU_INVALID;
+                else
+                    counts[i] = USE_SAT_BACKEND ? context.satSolver.countSolutions(board, limit) : context.solver.countSolutions(board, limit);
+            });
+
+            return SUDOKU_OK;
+        });
+    }
+
+    ptrdiff_t sudoku_validate_batch(const uint8_t* in, size_t n, int8_t* valid, int16_t* conflicts)
+    {
+        return guarded([&]() -> ptrdiff_t {
+            if (n == 0)
+                return 0;
+            if (!in || !valid)
+                return SUDOKU_ERROR_ARGUMENT;
+
+            std::atomic<std::size_t> validCount = 0;
+            get_engine().forEach((n + VALIDATION_GROUP_SIZE - 1) / VALIDATION_GROUP_SIZE,
+                                 [in, n, valid, conflicts, &validCount](WorkerContext&, std::size_t group) {
+                std::size_t first = group * VALIDATION_GROUP_SIZE;
+                std::size_t count = std::min(VALIDATION_GROUP_SIZE, n - first);
+                std::array<bool, VALIDATION_GROUP_SIZE> groupValid;
+                std::array<int, VALIDATION_GROUP_SIZE> groupConflicts;
+
+                std::span<int> conflictSpan = conflicts ? std::span<int>(groupConflicts.data(), count) : std::span<int>();
+                validCount += validate_grids({ in + first * SUDOKU_CELLS, count * SUDOKU_CELLS }, { groupValid.data(), count }, conflictSpan);
+
+                for (std::size_t i = 0; i < count; i++) {
+                    valid[first + i] = groupValid[i];
+                    if (conflicts)
+                        conflicts[first + i] = std::int16_t(groupConflicts[i]);
+                }
+            });
+
+            return static_cast<ptrdiff_t>(validCount.load());
+        });
+    }
+
+}
@@ -0,0 +1,105 @@
+#ifndef SUDOKU_H
+#define SUDOKU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * libsudoku - C interface of the sudoku solver.
+ *
+ * Puzzles are passed as SUDOKU_CELLS consecutive bytes in row-major order, where 0 stands for an empty field
+ * and 1-SUDOKU_SIZE for a filled one. Batch functions operate on contiguous buffers of n such puzzles owned by the caller,
+ * so no conversion nor copying of the whole batch takes place.
+ *
+ * The board size is fixed when building the library (9x9 by default). Clients of a 16x16 or 25x25 build define
+ * SUDOKU_BOX_SIZE as 4 or 5 before including this header, and may verify it with sudoku_board_size().
+ *
+ * All the functions are thread safe.
+ */
+
+#if defined(_WIN32)
+    #if defined(SUDOKU_BUILD)
+        #define SUDOKU_API __declspec(dllexport)
+    #else
+        #define SUDOKU_API __declspec(dllimport)
+    #endif
+#else
+    #define SUDOKU_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUDOKU_API_VERSION 4
+
+#ifndef SUDOKU_BOX_SIZE
+#define SUDOKU_BOX_SIZE 3
+#endif
+#define SUDOKU_SIZE (SUDOKU_BOX_SIZE * SUDOKU_BOX_SIZE)
+#define SUDOKU_CELLS (SUDOKU_SIZE * SUDOKU_SIZE)
+
+/* Per-puzzle results of batch functions */
+enum sudoku_status
+{
+    SUDOKU_UNSOLVABLE = 0,
+    SUDOKU_SOLVED = 1,
+    SUDOKU_INVALID = -1         /* Input contains a value outside of the 0-SUDOKU_SIZE range */
+};
+
+/* Return codes of functions which do not report per-puzzle results */
+enum sudoku_error
+{
+    SUDOKU_OK = 0,
+    SUDOKU_ERROR_ARGUMENT = -1,
+    SUDOKU_ERROR_STATE = -2,    /* Operation not allowed in the current library state */
+    SUDOKU_ERROR_RESOURCE = -3  /* Out of memory or unable to start the worker threads (since API version 4) */
+};
+
+/* Every function except the two below may return SUDOKU_ERROR_RESOURCE, even those returning sudoku_status values */
+
+/* Returns SUDOKU_API_VERSION of the loaded library */
+SUDOKU_API int sudoku_api_version(void);
+
+/* Returns SUDOKU_SIZE of the loaded library (9, 16 or 25) */
+SUDOKU_API int sudoku_board_size(void);
+
+/*
+ * Sets the number of internal worker threads (0 stands for the number of hardware threads, which is the default).
+ * Must be called before the first batch call, returns SUDOKU_ERROR_STATE otherwise.
+ */
+SUDOKU_API int sudoku_set_thread_count(unsigned threads);
+
+/*
+ * Solves a single puzzle on the calling thread. in and out may point to the same buffer.
+ * Returns one of sudoku_status values.
+ */
+SUDOKU_API int sudoku_solve(const uint8_t* in, uint8_t* out);
+
+/*
+ * Solves n puzzles from in (n * SUDOKU_CELLS bytes) on the internal worker threads and writes the solutions to out
+ * (n * SUDOKU_CELLS bytes, may be the same buffer as in). Unsolved puzzles are copied to out unchanged.
+ * If status is not NULL, it receives n sudoku_status values. Blocks until the whole batch is processed.
+ * Returns the number of solved puzzles or SUDOKU_ERROR_ARGUMENT.
+ */
+SUDOKU_API ptrdiff_t sudoku_solve_batch(const uint8_t* in, uint8_t* out, size_t n, int8_t* status);
+
+/*
+ * Counts solutions of n puzzles from in, stopping at limit solutions per puzzle, and writes them to counts.
+ * Invalid puzzles are given a count of SUDOKU_INVALID. Returns SUDOKU_OK or SUDOKU_ERROR_ARGUMENT.
+ */
+SUDOKU_API int sudoku_count_batch(const uint8_t* in, size_t n, int limit, int32_t* counts);
+
+/*
+ * Checks n completed grids from in (n * SUDOKU_CELLS bytes) - every row, column and inner square must hold every
+ * number exactly once. valid receives n values (1 or 0). If conflicts is not NULL, it receives the index of the first
+ * conflicting cell of every invalid grid (row-major; an empty or out of range field, or a repeated number) and -1
+ * for the valid ones. Returns the number of valid grids or SUDOKU_ERROR_ARGUMENT. Available since API version 3.
+ */
+SUDOKU_API ptrdiff_t sudoku_validate_batch(const uint8_t* in, size_t n, int8_t* valid, int16_t* conflicts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,174 @@
+#include "json.h"
+#include <cctype>
+#include <cstdlib>
+
+
+namespace Daemon {
+
+    // -----------
+    // JSON parser
+    // -----------
+
+    // A minimal recursive descent parser over a flat object
+    class JsonParser
+    {
+    public:
+        JsonParser(const std::string& text) : text(text) {}
+
+        std::optional<JsonObject> parseObject();
+
+    private:
+        bool parseValue(JsonField& field);
+        bool parseString(std::string& result);
+        bool parseScalar(std::string& result);      // Numbers and literals
+        void skipWhitespace() { while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++; }
+        bool consume(char sym) { skipWhitespace(); if (pos < text.size() && text[pos] == sym) { pos++; return true; } return false; }
+
+        const std::string& text;
+        std::size_t pos = 0;
+    };
+
+    std::optional<JsonObject> JsonParser::parseObject()
+    {
+        JsonObject object;
+        if (!consume('{'))
+            return std::nullopt;
+
+        if (!consume('}')) {
+            do {
+                std::string key;
+                JsonField field;
+                skipWhitespace();
+                if (!parseString(key) || !consume(':') || !parseValue(field))
+                    return std::nullopt;
+                object[key] = std::move(field);
+            } while (consume(','));
+
+            if (!consume('}'))
+                return std::nullopt;
+        }
+
+        skipWhitespace();
+        return pos == text.size() ? std::make_optional(std::move(object)) : std::nullopt;
+    }
+
+    bool JsonParser::parseValue(JsonField& field)
+    {
+        skipWhitespace();
+        std::size_t start = pos;
+
+        if (pos < text.size() && text[pos] == '"') {
+            std::string str;
+            if (!parseString(str))
+                return false;
+            field.value = std::move(str);
+        }
+        else if (pos < text.size() && text[pos] == '[') {
+            pos++;
+            JsonArray array;
+            if (!consume(']')) {
+                do {
+                    skipWhitespace();
+                    std::string element;
+                    if (!(pos < text.size() && text[pos] == '"' ? parseString(element) : parseScalar(element)))
+                        return false;
+                    array.push_back(std::move(element));
+                } while (consume(','));
+
+                if (!consume(']'))
+                    return false;
+            }
+            field.value = std::move(array);
+        }
+        else {
+            std::string scalar;
+            if (!parseScalar(scalar))
+                return false;
+
+            if (scalar == "true" || scalar == "false")
+                field.value = scalar == "true";
+            else if (scalar == "null")
+                field.value = nullptr;
+            else {
+                char* end = nullptr;
+                double number = std::strtod(scalar.c_str(), &end);
+                if (end != scalar.c_str() + scalar.size())
+                    return false;
+                field.value = number;
+            }
+        }
+
+        field.raw = text.substr(start, pos - start);
+        return true;
+    }
+
+    bool JsonParser::parseString(std::string& result)
+    {
+        if (pos >= text.size() || text[pos] != '"')
+            return false;
+
+        for (pos++; pos < text.size(); pos++) {
+            char sym = text[pos];
+            if (sym == '"') {
+                pos++;
+                return true;
+            }
+            if (sym == '\\') {
+                if (++pos >= text.size())
+                    return false;
+                switch (text[pos]) {
+                    case 'n': result += '\n'; break;
+                    case 't': result += '\t'; break;
+                    case 'r': result += '\r'; break;
+                    case 'b': result += '\b'; break;
+                    case 'f': result += '\f'; break;
+                    case 'u': return false;     // Puzzles and commands are plain ASCII
+                    default: result += text[pos]; break;
+                }
+            }
+            else
+                result += sym;
+        }
+
+        return false;
+    }
+
+    bool JsonParser::parseScalar(std::string& result)
+    {
+        std::size_t start = pos;
+        while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '-' ||
+                                     text[pos] == '+' || text[pos] == '.'))
+            pos++;
+
+        result = text.substr(start, pos - start);
+        return !result.empty();
+    }
+
+    std::optional<JsonObject> parse_json_object(const std::string& text)
+    {
+        return JsonParser(text).parseObject();
+    }
+
+
+    // -----------
+    // JSON output
+    // -----------
+
+    std::string json_quote(const std::string& text)
+    {
+        std::string result = "\"";
+        for (char sym : text) {
+            switch (sym) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\t': result += "\\t"; break;
+                case '\r': result += "\\r"; break;
+                default: result += sym; break;
+            }
+        }
+
+        return result + "\"";
+    }
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+
+namespace Daemon {
+
+    // ----------------
+    // Flat JSON values
+    // ----------------
+
+    // Requests are flat JSON objects, so nested objects are not supported - only scalars and arrays of scalars
+    using JsonArray = std::vector<std::string>;     // Array elements are kept as raw strings (unquoted in case of strings)
+    using JsonValue = std::variant<std::nullptr_t, bool, double, std::string, JsonArray>;
+
+    struct JsonField
+    {
+        JsonValue value;
+        std::string raw;                            // Source text of the value, allows to echo it back unchanged
+    };
+
+    using JsonObject = std::unordered_map<std::string, JsonField>;
+
+    // Returns std::nullopt in case of syntax errors
+    std::optional<JsonObject> parse_json_object(const std::string& text);
+
+    // Output helpers
+    std::string json_quote(const std::string& text);
+
+}
@@ -0,0 +1,121 @@
+#include "server.h"
+#include "../logic/traceSpans.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <signal.h>
+#include <unistd.h>
+
+using namespace Daemon;
+
+
+void print_usage()
+{
+    std::cerr << "Usage: sudokud [--socket <path>] [--threads <n>] [--heuristic <name>] [--sat] [--no-stdio] [--trace <path>]\n"
+                 "Serves solve, count, generate and rate requests (JSON lines or binary frames)\n"
+                 "on the given Unix domain socket and on standard input / output.\n"
+                 "Heuristics: mrv (default), mrv-degree, lcv, restarts, adaptive\n"
+                 "--sat solves and counts with the CDCL backend instead of the search (default on boards bigger than 9x9)\n"
+                 "--trace records the solver and generator phases as a Chrome trace, written at shutdown (SIGTERM, SIGINT,\n"
+                 "        or the end of standard input if there is no socket)\n";
+}
+
+int main(int argc, char** argv)
+{
+    std::string socketPath, tracePath;
+    unsigned threads = 0;
+    std::optional<Sudoku::HeuristicType> heuristic;
+    bool satBackend = Sudoku::BOARD_SIZE > 9;
+    bool useStdio = true;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc)
+            socketPath = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc)
+            threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--heuristic" && i + 1 < argc) {
+            Sudoku::HeuristicType type;
+            if (!Sudoku::parse_heuristic(argv[++i], type)) {
+                print_usage();
+                return EXIT_FAILURE;
+            }
+            heuristic = type;
+        }
+        else if (arg == "--sat")
+            satBackend = true;
+        else if (arg == "--no-stdio")
+            useStdio = false;
+        else if (arg == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else {
+            print_usage();
+            return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (!useStdio && socketPath.empty()) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    // Disconnected clients are detected by write errors instead
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Termination signals are handled by a dedicated thread (blocked before any other thread starts, which inherit the mask)
+    sigset_t shutdownSignals;
+    sigemptyset(&shutdownSignals);
+    sigaddset(&shutdownSignals, SIGTERM);
+    sigaddset(&shutdownSignals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &shutdownSignals, nullptr);
+
+    Sudoku::set_span_tracing(!tracePath.empty());
+    SolverService service(threads, heuristic, satBackend);
+
+    // Written once, by whichever way the daemon ends first
+    static std::once_flag traceWritten;
+    auto writeTrace = [tracePath]() {
+        std::call_once(traceWritten, [&tracePath]() {
+            if (!tracePath.empty() && !Sudoku::write_span_trace(tracePath))
+                std::cerr << "sudokud: cannot write " << tracePath << std::endl;
+        });
+    };
+
+    std::thread([shutdownSignals, socketPath, writeTrace]() {
+        int signal = 0;
+        sigwait(&shutdownSignals, &signal);
+
+        // Requests still in progress are abandoned, the spans recorded so far are kept
+        writeTrace();
+        if (!socketPath.empty())
+            ::unlink(socketPath.c_str());
+        std::_Exit(EXIT_SUCCESS);
+    }).detach();
+
+    try {
+        if (socketPath.empty()) {
+            std::make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO, service)->serve();
+            writeTrace();
+            return EXIT_SUCCESS;
+        }
+
+        // With a socket, the end of standard input does not end the daemon (nor the recording of its spans)
+        if (useStdio) {
+            std::thread([&service]() {
+                std::make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO, service)->serve();
+            }).detach();
+        }
+
+        serve_unix_socket(socketPath, service);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "sudokud: " << e.what() << std::endl;
+        writeTrace();
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,288 @@
+#include "protocol.h"
+#include "json.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+
+namespace Daemon {
+
+    // Customizable parameters
+    constexpr int MAX_SOLUTION_LIMIT = 1 << 24;
+    constexpr int MAX_GENERATE_COUNT = 1 << 16;
+
+    constexpr int CELL_COUNT = Sudoku::BOARD_SIZE * Sudoku::BOARD_SIZE;
+
+    constexpr std::pair<const char*, Operation> OPERATION_NAMES[] = {
+        {"solve", Operation::SOLVE}, {"count", Operation::COUNT}, {"generate", Operation::GENERATE}, {"rate", Operation::RATE},
+        {"stats", Operation::STATS}
+    };
+
+
+    // ------------------------
+    // JSON lines serialization
+    // ------------------------
+
+    // Seeds are read from the source text of an integer, or from a string of digits - doubles hold only 53 bits exactly
+    std::optional<std::uint64_t> parse_seed(const JsonField& field)
+    {
+        const std::string* text = std::get_if<std::string>(&field.value);
+        if (text == nullptr) {
+            if (!std::holds_alternative<double>(field.value))
+                return std::nullopt;
+            text = &field.raw;
+        }
+
+        std::uint64_t seed = 0;
+        auto [end, error] = std::from_chars(text->data(), text->data() + text->size(), seed);
+        if (error != std::errc() || end != text->data() + text->size())
+            return std::nullopt;
+        return seed;
+    }
+
+    // Board::load skips unknown symbols, so a puzzle is accepted only with exactly one symbol for every field
+    bool load_puzzle(const std::string& setup, Request& request)
+    {
+        if (Sudoku::field_symbol_count(setup) != CELL_COUNT) {
+            request.error = "malformed puzzle";
+            return false;
+        }
+
+        request.puzzles.emplace_back();
+        request.puzzles.back().load(setup);
+        return true;
+    }
+
+    Request parse_json_request(const std::string& line)
+    {
+        Request request;
+
+        std::optional<JsonObject> object = parse_json_object(line);
+        if (!object.has_value()) {
+            request.error = "malformed JSON";
+            return request;
+        }
+
+        if (object->contains("id"))
+            request.id = object->at("id").raw;
+
+        // Operation
+        const std::string* op = object->contains("op") ? std::get_if<std::string>(&object->at("op").value) : nullptr;
+        bool known = false;
+        for (const auto& [name, operation] : OPERATION_NAMES) {
+            if (op != nullptr && *op == name) {
+                request.operation = operation;
+                known = true;
+            }
+        }
+        if (!known) {
+            request.error = "unknown operation";
+            return request;
+        }
+
+        // Numeric parameters - clamped before the conversion, which is undefined for values out of the integer range
+        auto getNumber = [&object, &request](const char* key, int defaultValue, int maxValue) {
+            const double* number = object->contains(key) ? std::get_if<double>(&object->at(key).value) : nullptr;
+            if (number == nullptr)
+                return defaultValue;
+            if (!std::isfinite(*number)) {
+                request.error = std::string("invalid ") + key;
+                return defaultValue;
+            }
+            return static_cast<int>(std::clamp(*number, 1.0, static_cast<double>(maxValue)));
+        };
+        request.limit = getNumber("limit", request.limit, MAX_SOLUTION_LIMIT);
+        if (!request.error.empty())
+            return request;
+
+        // Puzzles
+        if (request.operation == Operation::STATS)
+            request.puzzles.resize(1);
+        else if (request.operation == Operation::GENERATE) {
+            int count = getNumber("count", 1, MAX_GENERATE_COUNT);
+            request.puzzles.resize(count);
+            request.batch = object->contains("count");
+
+            if (object->contains("seed")) {
+                request.seed = parse_seed(object->at("seed"));
+                if (!request.seed.has_value())
+                    request.error = "invalid seed";
+            }
+        }
+        else if (object->contains("puzzles") && std::holds_alternative<JsonArray>(object->at("puzzles").value)) {
+            for (const std::string& setup : std::get<JsonArray>(object->at("puzzles").value)) {
+                if (!load_puzzle(setup, request))
+                    break;
+            }
+            request.batch = true;
+        }
+        else if (object->contains("puzzle") && std::holds_alternative<std::string>(object->at("puzzle").value))
+            load_puzzle(std::get<std::string>(object->at("puzzle").value), request);
+        else
+            request.error = "missing puzzle";
+
+        return request;
+    }
+
+    std::string format_json_result(const Request& request, const Result& result)
+    {
+        switch (request.operation) {
+            case Operation::SOLVE:
+                return "\"solved\":" + std::string(result.solved ? "true" : "false") +
+                       (result.solved ? ",\"solution\":" + json_quote(result.board.toString()) : "");
+            case Operation::COUNT:
+                return "\"count\":" + std::to_string(result.count);
+            case Operation::GENERATE:
+                return "\"puzzle\":" + json_quote(result.board.toString());
+            case Operation::RATE:
+                return "\"difficulty\":" + json_quote(Sudoku::difficulty_name(result.rating.difficulty)) +
+                       ",\"score\":" + std::to_string(result.rating.score) +
+                       ",\"unique\":" + (result.rating.unique ? "true" : "false");
+            case Operation::STATS:
+                return "\"latency\":" + result.latency;
+        }
+
+        return "";
+    }
+
+    std::string format_json_response(const Request& request, const std::vector<Result>& results)
+    {
+        std::string response = "{\"id\":" + request.id;
+
+        if (!request.error.empty())
+            return response + ",\"ok\":false,\"error\":" + json_quote(request.error) + "}\n";
+
+        response += ",\"ok\":true,";
+        if (request.batch) {
+            response += "\"results\":[";
+            for (std::size_t i = 0; i < results.size(); i++)
+                response += (i > 0 ? ",{" : "{") + format_json_result(request, results[i]) + "}";
+            response += "]";
+        }
+        else if (!results.empty())
+            response += format_json_result(request, results.front());
+
+        return response + "}\n";
+    }
+
+
+    // --------------------
+    // Binary serialization
+    // --------------------
+
+    std::uint32_t read_u32(const unsigned char* data)
+    {
+        return std::uint32_t(data[0]) | std::uint32_t(data[1]) << 8 | std::uint32_t(data[2]) << 16 | std::uint32_t(data[3]) << 24;
+    }
+
+    void append_u32(std::string& output, std::uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            output += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+
+    void append_board(std::string& output, const Sudoku::Board& board)
+    {
+        for (int r = 0; r < Sudoku::BOARD_SIZE; r++) {
+            for (int c = 0; c < Sudoku::BOARD_SIZE; c++)
+                output += static_cast<char>(board.getNumber(r, c));
+        }
+    }
+
+    std::optional<std::size_t> parse_binary_header(const unsigned char* header, Request& request)
+    {
+        request.encoding = Encoding::BINARY;
+        request.batch = true;
+        request.binaryId = read_u32(header + 4);
+        request.binaryOperation = header[1];
+        request.id = std::to_string(request.binaryId);
+
+        std::uint32_t items = read_u32(header + 8);
+        std::uint32_t limit = read_u32(header + 12);
+
+        bool known = header[1] >= std::uint8_t(Operation::SOLVE) && header[1] <= std::uint8_t(Operation::RATE);
+        if (known) {
+            request.operation = Operation(header[1]);
+            request.limit = std::clamp(static_cast<int>(std::min<std::uint32_t>(limit, MAX_SOLUTION_LIMIT)), 1, MAX_SOLUTION_LIMIT);
+        }
+
+        // GENERATE frames have no payload
+        if (known && request.operation == Operation::GENERATE) {
+            if (items > static_cast<std::uint32_t>(MAX_GENERATE_COUNT))
+                request.error = "too many items";
+            else
+                request.puzzles.resize(items);
+            return 0;
+        }
+
+        // A frame with too many puzzles is not skipped, as its payload could be too big to read
+        if (items > BINARY_MAX_ITEMS) {
+            request.error = "too many items";
+            return std::nullopt;
+        }
+        // Frames of unknown operations are assumed to carry puzzles, which are skipped
+        if (!known) {
+            request.error = "unknown operation";
+            return std::size_t(items) * CELL_COUNT;
+        }
+
+        // The puzzles are allocated only once their payload arrives, so that a header alone cannot claim the memory
+        request.binaryItems = items;
+        return std::size_t(items) * CELL_COUNT;
+    }
+
+    void parse_binary_payload(const unsigned char* payload, Request& request)
+    {
+        if (request.operation == Operation::GENERATE)
+            return;
+
+        request.puzzles.resize(request.binaryItems);
+        for (std::size_t i = 0; i < request.puzzles.size(); i++) {
+            for (int cell = 0; cell < CELL_COUNT; cell++) {
+                int num = payload[i * CELL_COUNT + cell];
+                request.puzzles[i].setNumber(cell / Sudoku::BOARD_SIZE, cell % Sudoku::BOARD_SIZE, num <= Sudoku::BOARD_SIZE ? num : 0);
+            }
+        }
+    }
+
+    std::string format_binary_response(const Request& request, const std::vector<Result>& results)
+    {
+        std::string response;
+        response += static_cast<char>(BINARY_MAGIC);
+        response += static_cast<char>(request.binaryOperation);
+        response += static_cast<char>(request.error.empty() ? 0 : 1);
+        response += '\0';
+        append_u32(response, request.binaryId);
+        append_u32(response, static_cast<std::uint32_t>(request.error.empty() ? results.size() : 0));
+        append_u32(response, 0);
+
+        if (!request.error.empty())
+            return response;
+
+        for (const Result& result : results) {
+            switch (request.operation) {
+                case Operation::SOLVE:
+                    response += static_cast<char>(result.solved);
+                    append_board(response, result.board);
+                    break;
+                case Operation::COUNT:
+                    append_u32(response, static_cast<std::uint32_t>(result.count));
+                    break;
+                case Operation::GENERATE:
+                    append_board(response, result.board);
+                    break;
+                case Operation::RATE:
+                    response += static_cast<char>(result.rating.difficulty);
+                    response += static_cast<char>(result.rating.unique);
+                    response += std::string(2, '\0');
+                    append_u32(response, static_cast<std::uint32_t>(result.rating.score));
+                    break;
+                case Operation::STATS:
+                    break;
+            }
+        }
+
+        return response;
+    }
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../logic/rating.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace Daemon {
+
+    // --------------
+    // Request format
+    // --------------
+
+    enum class Operation : std::uint8_t {
+        SOLVE = 1,
+        COUNT,
+        GENERATE,
+        RATE,
+        STATS               // Latency summaries of the other operations, available only in JSON
+    };
+
+    enum class Encoding { JSON, BINARY };
+
+    struct Request
+    {
+        Encoding encoding = Encoding::JSON;
+        Operation operation = Operation::SOLVE;
+        std::string id = "null";            // JSON representation of the request identifier
+        std::uint32_t binaryId = 0;
+        std::uint32_t binaryItems = 0;      // Number of puzzles in the binary payload
+        std::uint8_t binaryOperation = 0;   // Operation byte of the binary header, echoed back even if unknown
+        std::vector<Sudoku::Board> puzzles; // For GENERATE only the number of elements matters
+        bool batch = false;                 // Batch requests receive an array of results
+        int limit = 2;                      // Maximum number of solutions to count
+        std::optional<std::uint64_t> seed;  // GENERATE - puzzle i is then determined by the seed and i only
+        std::string error;                  // Set if the request could not be parsed
+    };
+
+    // Outcome of processing a single puzzle
+    struct Result
+    {
+        bool solved = false;
+        Sudoku::Board board;                // Solution or generated puzzle
+        int count = 0;
+        Sudoku::Rating rating;
+        std::string latency;                // STATS - JSON object with a latency summary of every operation
+    };
+
+
+    // ------------------------
+    // JSON lines serialization
+    // ------------------------
+
+    // {"id": 1, "op": "solve", "puzzle": "53..7...."}
+    // {"id": 2, "op": "count", "puzzles": ["...", "..."], "limit": 10}
+    // {"id": 3, "op": "generate", "count": 4, "seed": 42}
+    // {"id": 4, "op": "stats"}
+    Request parse_json_request(const std::string& line);
+    std::string format_json_response(const Request& request, const std::vector<Result>& results);
+
+
+    // --------------------
+    // Binary serialization
+    // --------------------
+
+    // Both requests and responses start with a 16-byte little-endian header:
+    // magic (u8), operation (u8), status (u8), reserved (u8), id (u32), number of items (u32), limit (u32)
+    // Request payload holds BOARD_SIZE^2 bytes per puzzle (values 0-BOARD_SIZE), except for GENERATE, which has none.
+    // Response payload per item: SOLVE - solved flag (u8) and the board, COUNT - count (u32),
+    // GENERATE - the board, RATE - difficulty (u8), unique flag (u8), reserved (u16), score (u32).
+    // GENERATE requests are limited to as many puzzles as the JSON ones.
+    constexpr unsigned char BINARY_MAGIC = 0xB5;
+    constexpr std::size_t BINARY_HEADER_SIZE = 16;
+    constexpr std::uint32_t BINARY_MAX_ITEMS = 1 << 20;
+
+    // Returns the payload size, or std::nullopt if the frame cannot be skipped (the connection is then closed after the response)
+    std::optional<std::size_t> parse_binary_header(const unsigned char* header, Request& request);
+    void parse_binary_payload(const unsigned char* payload, Request& request);
+    std::string format_binary_response(const Request& request, const std::vector<Result>& results);
+
+}
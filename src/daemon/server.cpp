@@ -0,0 +1,220 @@
+#include "server.h"
+#include <cctype>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace Daemon {
+
+    // Customizable parameters
+    constexpr std::size_t READ_CHUNK_SIZE = 1 << 16;
+    constexpr std::size_t MAX_LINE_LENGTH = 1 << 26;
+    constexpr int LISTEN_BACKLOG = 64;
+    constexpr std::size_t MAX_PENDING_REQUESTS = 256;       // Per connection - reading stops until some responses are sent
+    constexpr auto ACCEPT_RETRY_DELAY = std::chrono::milliseconds(100);   // After running out of descriptors or memory
+
+
+    // ------------------
+    // Connection methods
+    // ------------------
+
+    Connection::Connection(int inputFd, int outputFd, SolverService& service)
+        : inputFd(inputFd), outputFd(outputFd), service(service)
+    {
+    }
+
+    void Connection::serve()
+    {
+        while (true) {
+            // Skip whitespace between messages
+            while (bufferPos < buffer.size() && std::isspace(static_cast<unsigned char>(buffer[bufferPos])))
+                bufferPos++;
+            if (bufferPos == buffer.size() && !fillBuffer())
+                break;
+            if (bufferPos == buffer.size() || std::isspace(static_cast<unsigned char>(buffer[bufferPos])))
+                continue;
+
+            // The first byte of a message determines its encoding
+            Request request;
+            if (static_cast<unsigned char>(buffer[bufferPos]) == BINARY_MAGIC) {
+                std::string header, payload;
+                if (!readBytes(BINARY_HEADER_SIZE, header))
+                    break;
+
+                // Payloads of rejected frames are read as well, so that the next message starts at the right place
+                std::optional<std::size_t> payloadSize = parse_binary_header(reinterpret_cast<const unsigned char*>(header.data()), request);
+                if (!payloadSize.has_value()) {
+                    dispatch(std::move(request));
+                    break;
+                }
+                if (!readBytes(*payloadSize, payload))
+                    break;
+                if (request.error.empty())
+                    parse_binary_payload(reinterpret_cast<const unsigned char*>(payload.data()), request);
+            }
+            else {
+                std::string line;
+                if (!readLine(line))
+                    break;
+                request = parse_json_request(line);
+            }
+
+            dispatch(std::move(request));
+        }
+
+        // Wait until every response is delivered
+        std::unique_lock<std::mutex> lock(mutex);
+        responded.wait(lock, [this]() { return pending == 0; });
+    }
+
+    bool Connection::fillBuffer()
+    {
+        // Drop the already consumed part of the buffer
+        buffer.erase(0, bufferPos);
+        bufferPos = 0;
+
+        char chunk[READ_CHUNK_SIZE];
+        while (true) {
+            ssize_t bytes = ::read(inputFd, chunk, sizeof(chunk));
+            if (bytes > 0) {
+                buffer.append(chunk, static_cast<std::size_t>(bytes));
+                return true;
+            }
+            if (bytes < 0 && errno == EINTR)
+                continue;
+            return false;
+        }
+    }
+
+    bool Connection::readLine(std::string& line)
+    {
+        std::size_t end;
+        while ((end = buffer.find('\n', bufferPos)) == std::string::npos) {
+            if (buffer.size() - bufferPos > MAX_LINE_LENGTH)
+                return false;
+            // A final line without the line break is still accepted
+            if (!fillBuffer()) {
+                line = buffer.substr(bufferPos);
+                bufferPos = buffer.size();
+                return !line.empty();
+            }
+        }
+
+        line = buffer.substr(bufferPos, end - bufferPos);
+        bufferPos = end + 1;
+        return true;
+    }
+
+    bool Connection::readBytes(std::size_t count, std::string& bytes)
+    {
+        while (buffer.size() - bufferPos < count) {
+            if (!fillBuffer())
+                return false;
+        }
+
+        bytes = buffer.substr(bufferPos, count);
+        bufferPos += count;
+        return true;
+    }
+
+    void Connection::send(const std::string& data)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // After the client disappears, responses are silently dropped
+        std::size_t written = 0;
+        while (!outputBroken && written < data.size()) {
+            ssize_t bytes = ::write(outputFd, data.data() + written, data.size() - written);
+            if (bytes < 0 && errno == EINTR)
+                continue;
+            if (bytes <= 0)
+                outputBroken = true;
+            else
+                written += static_cast<std::size_t>(bytes);
+        }
+    }
+
+    void Connection::dispatch(Request request)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            responded.wait(lock, [this]() { return pending < MAX_PENDING_REQUESTS; });
+            pending++;
+        }
+
+        // The connection is kept alive until all of its responses are sent
+        std::shared_ptr<Connection> self = shared_from_this();
+        service.execute(std::move(request), [self](const Request& request, const std::vector<Result>& results) {
+            self->send(request.encoding == Encoding::JSON ? format_json_response(request, results) :
+                                                            format_binary_response(request, results));
+
+            std::lock_guard<std::mutex> lock(self->mutex);
+            self->pending--;
+            self->responded.notify_all();
+        });
+    }
+
+
+    // ------------------
+    // Server entry point
+    // ------------------
+
+    void serve_unix_socket(const std::string& path, SolverService& service)
+    {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+            throw std::invalid_argument("Socket path too long: " + path);
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+        int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0)
+            throw std::runtime_error(std::string("Unable to create socket: ") + std::strerror(errno));
+
+        // A stale socket file would be left by a previous instance that has been killed - but no other file is replaced
+        struct stat status;
+        if (::lstat(path.c_str(), &status) == 0) {
+            if (!S_ISSOCK(status.st_mode)) {
+                ::close(listenFd);
+                throw std::runtime_error("Refusing to replace " + path + ", which is not a socket");
+            }
+            ::unlink(path.c_str());
+        }
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listenFd, LISTEN_BACKLOG) < 0) {
+            ::close(listenFd);
+            throw std::runtime_error("Unable to listen on " + path + ": " + std::strerror(errno));
+        }
+
+        while (true) {
+            int clientFd = ::accept(listenFd, nullptr, nullptr);
+            if (clientFd < 0) {
+                int error = errno;
+                if (error == EINTR || error == ECONNABORTED)
+                    continue;
+                if (error != EMFILE && error != ENFILE && error != ENOBUFS && error != ENOMEM) {
+                    ::close(listenFd);
+                    throw std::runtime_error(std::string("Unable to accept connections: ") + std::strerror(error));
+                }
+
+                // Running out of resources may pass once some connections are closed
+                std::cerr << "sudokud: accept failed: " << std::strerror(error) << std::endl;
+                std::this_thread::sleep_for(ACCEPT_RETRY_DELAY);
+                continue;
+            }
+
+            std::thread([clientFd, &service]() {
+                std::make_shared<Connection>(clientFd, clientFd, service)->serve();
+                ::close(clientFd);
+            }).detach();
+        }
+    }
+
+}
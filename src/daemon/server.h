@@ -0,0 +1,57 @@
+#pragma once
+
+#include "service.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+
+namespace Daemon {
+
+    // ----------------
+    // Connection class
+    // ----------------
+
+    // A single client, talking either through a socket or through a pair of standard streams.
+    // Requests are read and dispatched without waiting for the previous responses (pipelining),
+    // and every response is written as soon as it is ready, tagged with the identifier of its request.
+    // A connection with too many requests in flight is not read until some of them are answered.
+    class Connection : public std::enable_shared_from_this<Connection>
+    {
+    public:
+        Connection(int inputFd, int outputFd, SolverService& service);
+
+        // Serves requests until the end of input, then waits for all the pending responses
+        void serve();
+
+    private:
+        bool fillBuffer();
+        bool readLine(std::string& line);
+        bool readBytes(std::size_t count, std::string& bytes);
+        void send(const std::string& data);
+        void dispatch(Request request);
+
+        const int inputFd;
+        const int outputFd;
+        SolverService& service;
+
+        // Input buffering
+        std::string buffer;
+        std::size_t bufferPos = 0;
+        bool outputBroken = false;
+
+        // Response tracking
+        std::mutex mutex;
+        std::condition_variable responded;     // Signalled after every response
+        std::size_t pending = 0;
+    };
+
+
+    // ------------------
+    // Server entry point
+    // ------------------
+
+    // Accepts connections on a Unix domain socket and serves each of them in a separate thread (never returns)
+    void serve_unix_socket(const std::string& path, SolverService& service);
+
+}
@@ -0,0 +1,132 @@
+#include "service.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+
+namespace Daemon {
+
+    // Customizable parameters
+    constexpr std::size_t CHUNKS_PER_WORKER = 4;
+
+    constexpr const char* LATENCY_NAMES[] = { "solve", "count", "generate", "rate" };
+
+
+    // ---------------------
+    // SolverService methods
+    // ---------------------
+
+    SolverService::SolverService(unsigned threads, std::optional<Sudoku::HeuristicType> heuristic, bool satBackend)
+        : pool(threads)
+    {
+        for (unsigned i = 0; i < pool.size(); i++) {
+            contexts.push_back(std::make_unique<WorkerContext>());
+            if (heuristic) {
+                contexts.back()->heuristic = Sudoku::make_heuristic(*heuristic, i);
+                contexts.back()->solver.setHeuristic(contexts.back()->heuristic.get());
+            }
+            if (satBackend)
+                contexts.back()->satSolver = std::make_unique<Sudoku::SatSolver>();
+        }
+    }
+
+    void SolverService::execute(Request request, Callback done)
+    {
+        // Shared state of all the chunks of a single request
+        struct Job
+        {
+            Request request;
+            std::vector<Result> results;
+            std::atomic<std::size_t> remainingChunks;
+            Callback done;
+        };
+
+        // Statistics are gathered on the calling thread, so that they are not delayed by the queued work
+        if (request.error.empty() && request.operation == Operation::STATS) {
+            std::vector<Result> results(1);
+            results.front().latency = latencyStats();
+            done(request, results);
+            return;
+        }
+
+        std::size_t items = request.error.empty() ? request.puzzles.size() : 0;
+        if (items == 0) {
+            std::vector<Result> noResults;
+            done(request, noResults);
+            return;
+        }
+
+        std::size_t chunkSize = std::max<std::size_t>(1, items / (pool.size() * CHUNKS_PER_WORKER));
+        std::size_t chunks = (items + chunkSize - 1) / chunkSize;
+
+        auto job = std::make_shared<Job>();
+        job->request = std::move(request);
+        job->results.resize(items);
+        job->remainingChunks = chunks;
+        job->done = std::move(done);
+
+        for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+            pool.submit([this, job, chunk, chunkSize, items](unsigned worker) {
+                WorkerContext& context = *contexts[worker];
+                Sudoku::LatencyHistogram& latencies = context.latencies[std::size_t(job->request.operation) - 1];
+                for (std::size_t i = chunk * chunkSize; i < std::min(items, (chunk + 1) * chunkSize); i++) {
+                    auto start = Sudoku::LatencyClock::now();
+                    process(context, job->request, i, job->results[i]);
+                    auto latency = Sudoku::LatencyClock::now() - start;
+
+                    std::lock_guard<std::mutex> lock(context.latencyMutex);
+                    latencies.record(latency);
+                }
+
+                // The last finished chunk reports the results
+                if (--job->remainingChunks == 0)
+                    job->done(job->request, job->results);
+            });
+        }
+    }
+
+    std::string SolverService::latencyStats()
+    {
+        std::string stats = "{";
+        for (std::size_t op = 0; op < OPERATION_COUNT; op++) {
+            Sudoku::LatencyHistogram merged(Sudoku::LatencyHistogram::DEFAULT_WINDOW * contexts.size());
+            for (const std::unique_ptr<WorkerContext>& context : contexts) {
+                std::lock_guard<std::mutex> lock(context->latencyMutex);
+                merged.merge(context->latencies[op]);
+            }
+            stats += (op > 0 ? ",\"" : "\"") + std::string(LATENCY_NAMES[op]) + "\":" + Sudoku::latency_json(merged.summary());
+        }
+
+        return stats + "}";
+    }
+
+    void SolverService::process(WorkerContext& context, const Request& request, std::size_t index, Result& result)
+    {
+        const Sudoku::Board& puzzle = request.puzzles[index];
+
+        switch (request.operation) {
+            case Operation::SOLVE:
+                result.board = puzzle;
+                result.solved = context.satSolver ? context.satSolver->solve(result.board) : context.solver.solve(result.board);
+                break;
+            case Operation::COUNT:
+                result.count = context.satSolver ? context.satSolver->countSolutions(puzzle, request.limit)
+                                                 : context.solver.countSolutions(puzzle, request.limit);
+                break;
+            case Operation::GENERATE:
+                if (request.seed) {
+                    Sudoku::RandomStream stream = Sudoku::RandomStream(*request.seed).fork(index);
+                    context.generator.generate(result.board, stream);
+                }
+                else
+                    context.generator.generate(result.board);
+                break;
+            case Operation::RATE:
+                result.rating = Sudoku::rate(context.solver, puzzle);
+                break;
+            case Operation::STATS:
+                break;
+        }
+    }
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "protocol.h"
+#include "../logic/generators.h"
+#include "../logic/latency.h"
+#include "../logic/satSolver.h"
+#include "../logic/threadPool.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+
+namespace Daemon {
+
+    // -------------------
+    // SolverService class
+    // -------------------
+
+    // Executes requests on a persistent pool of workers, each one with its own, warm solver instance.
+    // Batch requests are split into chunks processed in parallel.
+    class SolverService
+    {
+    public:
+        using Callback = std::function<void(const Request& request, const std::vector<Result>& results)>;
+
+        // With satBackend, solve and count requests are handled by SatSolver (rating and generation always use Solver)
+        explicit SolverService(unsigned threads = 0, std::optional<Sudoku::HeuristicType> heuristic = std::nullopt,
+                               bool satBackend = false);
+
+        // Returns immediately, the callback is called from a worker thread once the whole request is processed
+        void execute(Request request, Callback done);
+
+        std::string latencyStats();         // JSON object with the latency summary of every operation
+
+    private:
+        static constexpr std::size_t OPERATION_COUNT = std::size_t(Operation::RATE);   // Operations processing puzzles
+
+        struct WorkerContext
+        {
+            Sudoku::Solver solver;
+            Sudoku::Solver generatorSolver;     // Without the heuristic, whose random choices would make seeded generation irreproducible
+            Sudoku::PositionGenerator generator;
+            std::unique_ptr<Sudoku::BranchingHeuristic> heuristic;
+            std::unique_ptr<Sudoku::SatSolver> satSolver;
+
+            // Latencies of single puzzles, indexed by operation - locked only by their worker and latencyStats
+            std::array<Sudoku::LatencyHistogram, OPERATION_COUNT> latencies;
+            std::mutex latencyMutex;
+
+            WorkerContext() : generator(&generatorSolver) {}
+        };
+
+        static void process(WorkerContext& context, const Request& request, std::size_t index, Result& result);
+
+        std::vector<std::unique_ptr<WorkerContext>> contexts;
+        Sudoku::ThreadPool pool;        // Declared last, so that workers are stopped before the contexts are destroyed
+    };
+
+}
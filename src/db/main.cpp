@@ -0,0 +1,172 @@
+#include "../bench/corpus.h"
+#include "../logic/latency.h"
+#include "../logic/puzzleDatabase.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Sudoku;
+
+
+// ----------------
+// Helper functions
+// ----------------
+
+void print_usage()
+{
+    std::cerr << "Usage: sudoku-db <database> add <file>\n"
+                 "       sudoku-db <database> find <puzzle>...\n"
+                 "       sudoku-db <database> band <easy|medium|hard|expert> [--limit <n>]\n"
+                 "       sudoku-db <database> info\n"
+                 "Library of rated puzzles, keyed by their canonical form (puzzles are found in any of their\n"
+                 "equivalent forms - rotated, reflected, with permuted lines or numbers).\n"
+                 "add solves and rates the puzzles from the file (one per line) which are not stored yet\n"
+                 "find prints the stored data of the puzzles and their solutions\n"
+                 "band lists the puzzles of a difficulty\n";
+}
+
+void print_record(const PuzzleRecord& record)
+{
+    std::cout << difficulty_name(record.getDifficulty()) << ", " << record.clues << " clues, score " << record.score
+              << (record.unique ? ", unique" : ", ambiguous") << ", " << record.guesses << " guesses, "
+              << record.backtracks << " backtracks, solved in " << format_latency(std::chrono::nanoseconds(record.solveTime));
+}
+
+int add_puzzles(PuzzleDatabase& database, const std::string& path)
+{
+    std::vector<Board> puzzles;
+    try {
+        puzzles = read_puzzles(path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "sudoku-db: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Solver solver;
+    std::size_t counts[4] = {};
+    auto start = LatencyClock::now();
+    for (const Board& puzzle : puzzles) {
+        PuzzleDatabase::AddResult result = database.add(puzzle, solver);
+        if (result == PuzzleDatabase::AddResult::FAILED) {
+            std::cerr << "sudoku-db: cannot write the database" << std::endl;
+            return EXIT_FAILURE;
+        }
+        counts[int(result)]++;
+    }
+    std::chrono::duration<double> elapsed = LatencyClock::now() - start;
+
+    std::cout << counts[int(PuzzleDatabase::AddResult::ADDED)] << " added, " << counts[int(PuzzleDatabase::AddResult::KNOWN)]
+              << " known, " << counts[int(PuzzleDatabase::AddResult::UNSOLVABLE)] << " unsolvable, in "
+              << std::fixed << std::setprecision(3) << elapsed.count() << " s (" << database.size() << " puzzles stored)\n";
+    return EXIT_SUCCESS;
+}
+
+int find_puzzles(const PuzzleDatabase& database, const std::vector<std::string>& setups)
+{
+    bool allFound = true;
+    for (const std::string& setup : setups) {
+        Board puzzle, solution;
+        puzzle.load(setup);
+
+        auto start = LatencyClock::now();
+        const PuzzleRecord* record = database.find(puzzle, &solution);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(LatencyClock::now() - start);
+
+        std::cout << puzzle.toString() << ": ";
+        if (record) {
+            print_record(*record);
+            std::cout << "\n  solution " << solution.toString();
+        }
+        else
+            std::cout << "not found";
+        std::cout << "\n  lookup " << format_latency(elapsed) << "\n";
+        allFound &= record != nullptr;
+    }
+
+    return allFound ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int list_band(const PuzzleDatabase& database, Difficulty difficulty, std::size_t limit)
+{
+    std::span<const std::uint32_t> band = database.band(difficulty);
+    for (std::size_t i = 0; i < std::min(limit, band.size()); i++) {
+        const PuzzleRecord& record = database.record(band[i]);
+        std::cout << record.puzzleBoard().toString() << "  ";
+        print_record(record);
+        std::cout << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int print_info(const PuzzleDatabase& database)
+{
+    std::cout << BOARD_SIZE << "x" << BOARD_SIZE << " boards, " << database.size() << " puzzles\n";
+    for (int band = 0; band < DIFFICULTY_BANDS; band++)
+        std::cout << std::left << std::setw(8) << difficulty_name(Difficulty(band)) << database.band(Difficulty(band)).size() << "\n";
+
+    return EXIT_SUCCESS;
+}
+
+
+// --------
+// Commands
+// --------
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        print_usage();
+        return argc == 2 && std::string(argv[1]) == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::string path = argv[1], command = argv[2];
+    std::vector<std::string> args(argv + 3, argv + argc);
+
+    // Arguments of the band command
+    int difficulty = DIFFICULTY_BANDS;
+    std::size_t limit = SIZE_MAX;
+    if (command == "band" && !args.empty()) {
+        for (difficulty = 0; difficulty < DIFFICULTY_BANDS; difficulty++) {
+            if (args[0] == difficulty_name(Difficulty(difficulty)))
+                break;
+        }
+        if (args.size() == 3 && args[1] == "--limit")
+            limit = static_cast<std::size_t>(std::atol(args[2].c_str()));
+    }
+
+    bool valid = (command == "add" && args.size() == 1) || (command == "find" && !args.empty()) || (command == "info" && args.empty()) ||
+                 (command == "band" && difficulty < DIFFICULTY_BANDS && (args.size() == 1 || (args.size() == 3 && args[1] == "--limit")));
+    if (!valid) {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    PuzzleDatabase database;
+    if (!database.open(path, command == "add")) {
+        std::cerr << "sudoku-db: cannot open " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int status = EXIT_SUCCESS;
+    if (command == "add")
+        status = add_puzzles(database, args[0]);
+    else if (command == "find")
+        status = find_puzzles(database, args);
+    else if (command == "band")
+        status = list_band(database, Difficulty(difficulty), limit);
+    else
+        status = print_info(database);
+
+    if (!database.close()) {
+        std::cerr << "sudoku-db: cannot write the index of " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return status;
+}
@@ -6,8 +6,12 @@ namespace GUI {
     // Customizable parameters
     constexpr float INNER_GRID_THICKNESS_RATIO = 0.04f;
     constexpr float OUTER_GRID_THICKNESS_RATIO = 0.10f;
+    constexpr float PENCIL_MARK_FONT_RATIO = 0.36f;
 
     const sf::Color TILE_DEFAULT_COLOR = sf::Color::White;
+    const sf::Color PENCIL_MARK_COLOR = sf::Color(90, 90, 90);
+
+    const sf::Keyboard::Key PENCIL_MARKS_TOGGLE_KEY = sf::Keyboard::F2;   // Not a number symbol on any board size (P stands for 25)
 
 
     // -------------------------------------
@@ -17,14 +21,21 @@ namespace GUI {
     Board::Board(float tileSize, unsigned fontSize,
                  sf::Color innerGridColor, sf::Color outerGridColor,
                  sf::Color tileHighlightColor1, sf::Color tileHighlightColor2)
-        : innerGrid(tileSize * Sudoku::BOARD_SIZE, tileSize, INNER_GRID_THICKNESS_RATIO * tileSize, innerGridColor),
-          outerGrid(tileSize * Sudoku::BOARD_SIZE, tileSize * 3, OUTER_GRID_THICKNESS_RATIO * tileSize, outerGridColor),
+        : glyphAtlas(get_font(Resource::MAIN_FONT), Sudoku::BOARD_SIZE,
+                     fontSize, tileSize, static_cast<unsigned>(PENCIL_MARK_FONT_RATIO * fontSize), tileSize / Sudoku::INNER_SQUARE_SIZE),
+          backgroundMesh(sf::Quads, 4 * Sudoku::BOARD_SIZE * Sudoku::BOARD_SIZE),
+          textMesh(sf::Quads, 4 * Sudoku::BOARD_SIZE * Sudoku::BOARD_SIZE),
+          pencilMesh(sf::Quads, 4 * Sudoku::BOARD_SIZE * Sudoku::BOARD_SIZE * Sudoku::BOARD_SIZE),
+          innerGrid(tileSize * Sudoku::BOARD_SIZE, tileSize, INNER_GRID_THICKNESS_RATIO * tileSize, innerGridColor),
+          outerGrid(tileSize * Sudoku::BOARD_SIZE, tileSize * Sudoku::INNER_SQUARE_SIZE, OUTER_GRID_THICKNESS_RATIO * tileSize, outerGridColor),
           tileSize(tileSize), boardSize(tileSize * Sudoku::BOARD_SIZE),
           tileHighlightColor1(tileHighlightColor1), tileHighlightColor2(tileHighlightColor2)
     {
         for (auto& row : tiles) {
-            for (auto& tile : row)
-                tile = Tile(tileSize, fontSize);
+            for (auto& tile : row) {
+                tile = Tile(tileSize);
+                tile.setPencilMarkColor(PENCIL_MARK_COLOR);
+            }
         }
 
         alignElements();
@@ -37,6 +48,12 @@ namespace GUI {
 
     std::optional<std::tuple<int, int, int>> Board::update(const sf::Event& event)
     {
+        // Case 0 - pencil marks toggle
+        if (event.type == sf::Event::KeyPressed && event.key.code == PENCIL_MARKS_TOGGLE_KEY) {
+            setPencilMarksVisible(!pencilMarksVisible);
+            return std::nullopt;
+        }
+
         // Case 1 - left mouse click
         // Activates new tile
         if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
@@ -56,12 +73,14 @@ namespace GUI {
         }
         // Case 2 - entering a number
         // Change text of the clicked tile or do nothing if no tile has been clicked
-        else if (event.type == sf::Event::TextEntered && event.text.unicode >= 49 && event.text.unicode <= 57 && isAnyTileSelected()) {
-            int num = event.text.unicode - 48;
+        else if (event.type == sf::Event::TextEntered && event.text.unicode < 128 &&
+                 Sudoku::symbol_number(static_cast<char>(event.text.unicode)) != 0 && isAnyTileSelected()) {
+            int num = Sudoku::symbol_number(static_cast<char>(event.text.unicode));
             auto result = std::make_tuple(selectedTile.first, selectedTile.second, num);
 
             // Update visualities
             tiles[selectedTile.first][selectedTile.second].setNumber(num);
+            updateTileMesh(selectedTile.first, selectedTile.second);
             updateTileVisibilities();
 
             return std::make_optional(result);
@@ -89,6 +108,7 @@ namespace GUI {
                 case sf::Keyboard::Delete:
                     result = std::make_tuple(selectedTile.first, selectedTile.second, 0);
                     tiles[selectedTile.first][selectedTile.second].removeNumber();
+                    updateTileMesh(selectedTile.first, selectedTile.second);
                     break;
                 default:
                     break;
@@ -112,8 +132,32 @@ namespace GUI {
     void Board::loadNumbers(const Sudoku::Board& board)
     {
         for (int r = 0; r < Sudoku::BOARD_SIZE; r++) {
-            for (int c = 0; c < Sudoku::BOARD_SIZE; c++)
-                tiles[r][c].setNumber(board.getNumber(r, c));
+            for (int c = 0; c < Sudoku::BOARD_SIZE; c++) {
+                if (tiles[r][c].getNumber() != board.getNumber(r, c)) {
+                    tiles[r][c].setNumber(board.getNumber(r, c));
+                    updateTileMesh(r, c);
+                }
+            }
+        }
+    }
+
+    void Board::setNumber(int row, int col, int number)
+    {
+        if (tiles[row][col].getNumber() != number) {
+            tiles[row][col].setNumber(number);
+            updateTileMesh(row, col);
+        }
+    }
+
+    void Board::loadCandidates(const Sudoku::CandidateMap& candidates)
+    {
+        for (int r = 0; r < Sudoku::BOARD_SIZE; r++) {
+            for (int c = 0; c < Sudoku::BOARD_SIZE; c++) {
+                if (tiles[r][c].getCandidates() != candidates.getCandidates(r, c)) {
+                    tiles[r][c].setCandidates(candidates.getCandidates(r, c));
+                    updateTileMesh(r, c);
+                }
+            }
         }
     }
 
@@ -128,6 +172,8 @@ namespace GUI {
             for (int c = 0; c < Sudoku::BOARD_SIZE; c++)
                 tiles[r][c].setPosition(sf::Vector2f(position.x + tileSize * r, position.y + tileSize * c));
         }
+
+        updateMesh();
     }
 
     void Board::updateTileVisibilities()
@@ -142,8 +188,29 @@ namespace GUI {
                     tiles[r][c].setBackgroundColor(tileHighlightColor2);
                 else
                     tiles[r][c].setBackgroundColor(TILE_DEFAULT_COLOR);
+                tiles[r][c].buildBackgroundQuad(&backgroundMesh[4 * (r * Sudoku::BOARD_SIZE + c)]);
             }
         }
+
+        redrawPending = true;
+    }
+
+    void Board::updateTileMesh(int row, int col)
+    {
+        std::size_t offset = 4 * (row * Sudoku::BOARD_SIZE + col);
+        tiles[row][col].buildBackgroundQuad(&backgroundMesh[offset]);
+        tiles[row][col].buildTextQuad(&textMesh[offset], glyphAtlas);
+        tiles[row][col].buildPencilQuads(&pencilMesh[offset * Sudoku::BOARD_SIZE], glyphAtlas);
+
+        redrawPending = true;
+    }
+
+    void Board::updateMesh()
+    {
+        for (int r = 0; r < Sudoku::BOARD_SIZE; r++) {
+            for (int c = 0; c < Sudoku::BOARD_SIZE; c++)
+                updateTileMesh(r, c);
+        }
     }
 
 
@@ -153,13 +220,17 @@ namespace GUI {
 
     void Board::draw(sf::RenderTarget& target, sf::RenderStates states) const
     {
-        // z-index 1: tiles
-        for (const auto& row : tiles) {
-            for (const auto& tile : row)
-                target.draw(tile, states);
-        }
+        // z-index 1: tile backgrounds
+        draw_primitive(target, backgroundMesh, states);
+
+        // z-index 2: numbers, textured with pre-rendered glyphs
+        sf::RenderStates textStates = states;
+        textStates.texture = &glyphAtlas.getTexture();
+        draw_primitive(target, textMesh, textStates);
+        if (pencilMarksVisible)
+            draw_primitive(target, pencilMesh, textStates);
 
-        // z-index 2: grids
+        // z-index 3: grids
         target.draw(innerGrid, states);
         target.draw(outerGrid, states);
     }
@@ -3,6 +3,7 @@
 #include "tile.h"
 #include "grid.h"
 #include "../logic/board.h"
+#include "../logic/candidates.h"
 #include <array>
 #include <optional>
 #include <tuple>
@@ -22,6 +23,12 @@ namespace GUI {
               sf::Color tileHighlightColor1, sf::Color tileHighlightColor2);
 
         void loadNumbers(const Sudoku::Board& board);
+        void setNumber(int row, int col, int number);                  // Single tile update, e.g. after undo
+        void loadCandidates(const Sudoku::CandidateMap& candidates);   // Updates only the tiles with changed candidates
+
+        // Pencil marks - candidates of empty tiles shown as a mini-grid
+        void setPencilMarksVisible(bool visible) { redrawPending |= pencilMarksVisible != visible; pencilMarksVisible = visible; }
+        bool arePencilMarksVisible() const { return pencilMarksVisible; }
 
         // Might return a (row, col, number) tuple representing the entered number
         std::optional<std::tuple<int, int, int>> update(const sf::Event& event);
@@ -30,6 +37,10 @@ namespace GUI {
         sf::Vector2f getPosition() const { return position; }
         sf::FloatRect getGlobalBounds() const { return sf::FloatRect(outerGrid.getPosition(), sf::Vector2f(boardSize, boardSize)); }
 
+        // Redraw tracking - the board reports whether its look has changed since the last draw
+        bool needsRedraw() const { return redrawPending; }
+        void markDrawn() { redrawPending = false; }
+
         void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
     private:
@@ -37,14 +48,24 @@ namespace GUI {
         void alignElements();
         void updateTileVisibilities();
 
+        // Mesh handlers - every tile owns a fixed quad inside both tile meshes
+        void updateTileMesh(int row, int col);
+        void updateMesh();
+
         // Graphic content
+        GlyphAtlas glyphAtlas;
         std::array<std::array<Tile, Sudoku::BOARD_SIZE>, Sudoku::BOARD_SIZE> tiles;
+        sf::VertexArray backgroundMesh;
+        sf::VertexArray textMesh;
+        sf::VertexArray pencilMesh;
         Grid innerGrid;
         Grid outerGrid;
 
         // Board parameters & logic
         sf::Vector2f position = {0, 0};
         std::pair<int, int> selectedTile = {-1, -1};
+        bool pencilMarksVisible = false;
+        bool redrawPending = true;
 
         const float tileSize;
         const float boardSize;
@@ -70,6 +70,7 @@ namespace GUI {
         if (eventType == sf::Event::MouseButtonPressed && !clicked) {
             onClick();
             clicked = true;
+            redrawPending = true;
 
             // The only case when we should signal environment that action related to button click should happen
             return true;
@@ -78,14 +79,18 @@ namespace GUI {
         else if (eventType == sf::Event::MouseButtonReleased) {
             onHover();
             clicked = false;
+            redrawPending = true;
         }
         // Either moved onto the button, or moved away from the button (reset case)
         else if (eventType == sf::Event::MouseMoved) {
-            if (onto && !checked)
+            if (onto && !checked) {
                 onHover();
+                redrawPending = true;
+            }
             else if (!onto && (clicked || checked)) {
                 clicked = false;
                 onDefault();
+                redrawPending = true;
             }
             checked = onto;
         }
@@ -133,8 +138,8 @@ namespace GUI {
 
     void RoundedButton::draw(sf::RenderTarget& target, sf::RenderStates states) const
     {
-        target.draw(background, states);
-     	target.draw(icon, states);
+        draw_primitive(target, background, states);
+     	draw_primitive(target, icon, states);
     }
 
 
@@ -165,7 +170,7 @@ namespace GUI {
 
     void LabeledButton::draw(sf::RenderTarget& target, sf::RenderStates states) const
     {
-        target.draw(text, states);
+        draw_primitive(target, text, states);
         RoundedButton::draw(target, states);
     }
 
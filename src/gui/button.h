@@ -62,11 +62,16 @@ namespace GUI {
         virtual void onDefault() = 0;
         virtual void onHover() = 0;
         virtual void onClick() = 0;
+
+        // Redraw tracking - set whenever the button changes its appearance
+        bool needsRedraw() const { return redrawPending; }
+        void markDrawn() { redrawPending = false; }
     
     protected:
         // Button state
         bool checked = false;
         bool clicked = false;
+        bool redrawPending = true;
     };
 
 
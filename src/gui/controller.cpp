@@ -1,4 +1,5 @@
 #include "controller.h"
+#include <algorithm>
 #include <chrono>
 
 
@@ -10,9 +11,9 @@ namespace GUI {
 
     // Board parameters
     const float BOARD_OFFSET = 3.f;
-    const float TILE_SIZE = 60.f;
+    const float TILE_SIZE = 540.f / Sudoku::BOARD_SIZE;        // Board keeps the same size regardless of the number of tiles
     const float BOARD_SIZE = TILE_SIZE * Sudoku::BOARD_SIZE;
-    const unsigned BOARD_FONT_SIZE = 42;
+    const unsigned BOARD_FONT_SIZE = 378 / Sudoku::BOARD_SIZE;
     const sf::Color INNER_GRID_COLOR = sf::Color(120, 120, 120);
     const sf::Color OUTER_GRID_COLOR = sf::Color(70, 70, 70);
     const sf::Color TILE_HIGHLIGHT_COLOR_MAIN = sf::Color(10, 164, 255, 150);
@@ -45,29 +46,59 @@ namespace GUI {
     const unsigned WINDOW_HEIGHT = 540 + static_cast<unsigned>(BOARD_OFFSET * 2);
     const sf::Color WINDOW_BACKGROUND_COLOR = sf::Color(230, 230, 230, 50);
 
+    // Main loop parameters
+    const sf::Time ANIMATION_FRAME_TIME = sf::seconds(1.f / 60.f);
+    const sf::Time EVENT_POLL_INTERVAL = sf::milliseconds(2);
+
+    // Solve replay parameters
+    const std::size_t SOLVE_TRACE_CAPACITY = 1 << 20;
+    const sf::Time REPLAY_STEP_TIME = sf::milliseconds(40);
+    const sf::Keyboard::Key REPLAY_KEY = sf::Keyboard::R;
+
+    // History parameters (with Ctrl held, Ctrl + Shift + UNDO_KEY redoes as well)
+    const sf::Keyboard::Key UNDO_KEY = sf::Keyboard::Z;
+    const sf::Keyboard::Key REDO_KEY = sf::Keyboard::Y;
+
+    // Performance overlay parameters
+    const unsigned PERF_OVERLAY_TEXT_SIZE = 13;
+    const float PERF_OVERLAY_PADDING = 6.f;
+    const sf::Vector2f PERF_OVERLAY_POS = {BOARD_OFFSET + 6.f, BOARD_OFFSET + 6.f};
+    const sf::Keyboard::Key PERF_OVERLAY_KEY = sf::Keyboard::F3;
+
+    // Session parameters
+    const char* SESSION_FILE = "sudoku-session.log";       // Relative to the working directory
+
 
     // ------------------
     // Controller methods
     // ------------------
 
     Controller::Controller()
-        : generator(&solver),
+        : generator(&solver), solveTrace(SOLVE_TRACE_CAPACITY), tracePlayer(REPLAY_STEP_TIME),
           window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Sudoku", sf::Style::Close | sf::Style::Titlebar,
                  sf::ContextSettings(0, 0, 4, 1, 1, 0, false)),
           boardView(TILE_SIZE, BOARD_FONT_SIZE, INNER_GRID_COLOR, OUTER_GRID_COLOR, TILE_HIGHLIGHT_COLOR_MAIN, TILE_HIGHLIGHT_COLOR_SECOND),
           infoPanel(INFO_PANEL_TEXT_SIZE, INFO_PANEL_ICON_SPACING, INFO_PANEL_RANK_SPACING),
-          navbar(BT_SPACING)
+          navbar(BT_SPACING), perfOverlay(PERF_OVERLAY_TEXT_SIZE, PERF_OVERLAY_PADDING)
     {
          // Setup window
         window.setFramerateLimit(60);
-        if (icon.loadFromFile(RESOURCE_ROOT + "sudoku.png"))
-            window.setIcon(icon.getSize().x, icon.getSize().y, icon.getPixelsPtr());
+        const sf::Image& icon = get_image(Resource::WINDOW_ICON);
+        window.setIcon(icon.getSize().x, icon.getSize().y, icon.getPixelsPtr());
+
+        // Restore the previous session (if any)
+        session.open(SESSION_FILE, board, journal);
+        candidates.load(board);
+        mark_startup_phase("session restored");
 
         // Setup board
         boardView.setPosition(sf::Vector2f(BOARD_OFFSET, BOARD_OFFSET));
+        boardView.loadNumbers(board);
+        boardView.loadCandidates(candidates);
 
         // Setup info panel
         infoPanel.setPosition(INFO_PANEL_POS);
+        infoPanel.setCorrectness(isBoardCorrect());
 
         // Setup navbar
         navbar.setPosition(NAVBAR_POS);
@@ -79,6 +110,9 @@ namespace GUI {
                                        BT_COLOR_DEFAULT, BT_COLOR_ON_HOVER, BT_COLOR_ON_CLICK));
         navbar.addButton(LabeledButton(ButtonType::SOLVE, "Solve", BT_BIG_LABEL_SIZE, BT_TEXT_SPACING, BT_BIG_SIZE, BT_ROUND,
                                        BT_COLOR_DEFAULT, BT_COLOR_ON_HOVER, BT_COLOR_ON_CLICK), false, SOLVE_BUTTON_POS);
+
+        // Setup performance overlay (hidden until toggled)
+        perfOverlay.setPosition(PERF_OVERLAY_POS);
     }
 
     void Controller::run()
@@ -86,71 +120,269 @@ namespace GUI {
         sf::Event event;
 
         while (window.isOpen()) {
-            // Event processing
-            while (window.pollEvent(event)) {
-                if (event.type == sf::Event::Closed)
-					window.close();
-                
-                // Update sudoku board view
-                auto result = boardView.update(event);
-                if (result.has_value()) {
-                    int r = std::get<0>(result.value()), c = std::get<1>(result.value()), num = std::get<2>(result.value());
-                    int oldNum = board.getNumber(r, c);
-
-                    board.setNumber(r, c, num);
-
-                    if (oldNum != num)
-                        listOfChanges.push_back(std::make_tuple(r, c, oldNum, num));
-                    infoPanel.setCorrectness(board.isCorrect());
+            // Sleep until there is something to do - with no animation in progress, the loop blocks on the event queue
+            bool eventReceived = isAnimating() ? waitEvent(event, ANIMATION_FRAME_TIME) : window.waitEvent(event);
+            bool rendered = false;
+
+            {
+                // Frame time excludes the waiting above
+                Sudoku::ScopedTimer frameTimer(perfOverlay.slot(PerfOverlay::Section::FRAME));
+
+                // Event processing
+                if (eventReceived) {
+                    Sudoku::ScopedTimer eventTimer(perfOverlay.slot(PerfOverlay::Section::EVENTS));
+                    do {
+                        handleEvent(event);
+                    } while (window.pollEvent(event));
                 }
 
-                // Update buttons
-                ButtonType bType = navbar.update(event);
-                switch (bType) {
-                    case ButtonType::BACK:
-                        if (!listOfChanges.empty()) {
-                            auto lastChange = listOfChanges.back();
-
-                            board.setNumber(std::get<0>(lastChange), std::get<1>(lastChange), std::get<2>(lastChange));
-                            boardView.loadNumbers(board);
-                            infoPanel.setCorrectness(board.isCorrect());
-
-                            listOfChanges.erase(listOfChanges.end() - 1);
-                        }
-                        break;
-                    case ButtonType::CLEAR:
-                        board.clear();
-                        listOfChanges.clear();
-                        boardView.loadNumbers(board);
-                        break;
-                    case ButtonType::GENERATE:
-                        generator.generate(board);
-                        listOfChanges.clear();
-                        boardView.loadNumbers(board);
-                        infoPanel.setCorrectness(true);
-                        break;
-                    case ButtonType::SOLVE: {
-                        auto start = std::chrono::steady_clock::now();
-                        bool solveResult = solver.solve(board);
-                        auto end = std::chrono::steady_clock::now();
-
-                        listOfChanges.clear();
-                        boardView.loadNumbers(board);
-                        infoPanel.setCorrectness(solveResult);
-                        infoPanel.setSolveTime(static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()));
-                    }
-                    default:
-                        break;
+                if (window.isOpen())
+                    updateAnimations();
+
+                // Bound the size of the session log (written in the background)
+                if (session.needsSnapshot())
+                    session.snapshot(board, journal);
+
+                // Render, but only if any of the elements has changed
+                if (window.isOpen() && needsRedraw()) {
+                    Sudoku::ScopedTimer renderTimer(perfOverlay.slot(PerfOverlay::Section::RENDER));
+                    render();
+                    rendered = true;
                 }
             }
 
-            // Render
-			window.clear(WINDOW_BACKGROUND_COLOR);
-			window.draw(boardView);
-            window.draw(infoPanel);
-            window.draw(navbar);
-			window.display();
+            // Iterations without rendering are accounted to the next rendered frame
+            if (rendered)
+                perfOverlay.endFrame();
         }
     }
 
+    bool Controller::waitEvent(sf::Event& event, sf::Time timeout)
+    {
+        // SFML 2.5 does not provide waitEvent() with timeout, so we poll with short sleeps until the deadline
+        sf::Clock clock;
+        while (!window.pollEvent(event)) {
+            sf::Time remaining = timeout - clock.getElapsedTime();
+            if (remaining <= sf::Time::Zero)
+                return false;
+            sf::sleep(std::min(remaining, EVENT_POLL_INTERVAL));
+        }
+
+        return true;
+    }
+
+    void Controller::handleEvent(const sf::Event& event)
+    {
+        if (event.type == sf::Event::Closed) {
+            window.close();
+            return;
+        }
+
+        // Window content might have been lost (or scaled) by the system
+        if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus)
+            redrawRequested = true;
+
+        // Replay of the last solve
+        if (event.type == sf::Event::KeyPressed && event.key.code == REPLAY_KEY) {
+            startReplay();
+            return;
+        }
+
+        // Performance overlay
+        if (event.type == sf::Event::KeyPressed && event.key.code == PERF_OVERLAY_KEY) {
+            perfOverlay.toggle();
+            redrawRequested = true;
+            return;
+        }
+
+        // Undo / redo shortcuts
+        if (event.type == sf::Event::KeyPressed && event.key.control && (event.key.code == UNDO_KEY || event.key.code == REDO_KEY)) {
+            if (tracePlayer.isPlaying())
+                stopReplay();
+            if (event.key.code == REDO_KEY || event.key.shift)
+                redo();
+            else
+                undo();
+            return;
+        }
+
+        // Any interaction with the board or buttons interrupts the replay
+        if (tracePlayer.isPlaying() && (event.type == sf::Event::MouseButtonPressed || event.type == sf::Event::TextEntered ||
+                                        event.type == sf::Event::KeyPressed))
+            stopReplay();
+
+        // Update sudoku board view
+        std::optional<std::tuple<int, int, int>> result;
+        {
+            Sudoku::ScopedTimer timer(perfOverlay.slot(PerfOverlay::Section::BOARD_UPDATE));
+            result = boardView.update(event);
+        }
+        if (result.has_value()) {
+            int r = std::get<0>(result.value()), c = std::get<1>(result.value()), num = std::get<2>(result.value());
+            int oldNum = board.getNumber(r, c);
+
+            board.setNumber(r, c, num);
+            candidates.setNumber(r, c, num);
+            boardView.loadCandidates(candidates);
+
+            session.recordGroup(journal.record(Sudoku::cell_index(r, c), oldNum, num));
+            infoPanel.setCorrectness(isBoardCorrect());
+        }
+
+        // Update buttons
+        ButtonType bType = ButtonType::NONE;
+        {
+            Sudoku::ScopedTimer timer(perfOverlay.slot(PerfOverlay::Section::NAVBAR_UPDATE));
+            bType = navbar.update(event);
+        }
+        switch (bType) {
+            case ButtonType::BACK:
+                undo();
+                break;
+            case ButtonType::CLEAR: {
+                Sudoku::Board before = board;
+                board.clear();
+                session.recordGroup(journal.record(before, board));
+
+                candidates.clear();
+                boardView.loadNumbers(board);
+                boardView.loadCandidates(candidates);
+                break;
+            }
+            case ButtonType::GENERATE: {
+                // Bulk operations form a single undoable group
+                Sudoku::Board before = board;
+                auto start = Sudoku::LatencyClock::now();
+                generator.generate(board);
+                generateLatencies.record(Sudoku::LatencyClock::now() - start);
+                infoPanel.setLatencies(solveLatencies.summary(), generateLatencies.summary());
+                session.recordGroup(journal.record(before, board));
+
+                candidates.load(board);
+                boardView.loadNumbers(board);
+                boardView.loadCandidates(candidates);
+                infoPanel.setCorrectness(true);
+                break;
+            }
+            case ButtonType::SOLVE: {
+                solveStart = board;
+                solver.setTrace(&solveTrace);
+
+                // Bigger boards are solved by the SAT backend, which leaves no trace to replay
+                solveTrace.clear();
+                auto start = Sudoku::LatencyClock::now();
+                bool solveResult = Sudoku::BOARD_SIZE > 9 ? satSolver.solve(board) : solver.solve(board);
+                auto end = Sudoku::LatencyClock::now();
+                solveLatencies.record(end - start);
+
+                solver.setTrace(nullptr);
+                session.recordGroup(journal.record(solveStart, board));
+
+                candidates.load(board);
+                boardView.loadNumbers(board);
+                boardView.loadCandidates(candidates);
+                infoPanel.setCorrectness(solveResult);
+                infoPanel.setSolveTime(end - start);
+                infoPanel.setLatencies(solveLatencies.summary(), generateLatencies.summary());
+            }
+            default:
+                break;
+        }
+    }
+
+    void Controller::updateAnimations()
+    {
+        if (!tracePlayer.isPlaying())
+            return;
+
+        if (tracePlayer.advance(animationClock.restart())) {
+            boardView.loadNumbers(tracePlayer.getBoard());
+            boardView.loadCandidates(tracePlayer.getCandidates());
+        }
+
+        // Show the actual board once the replay is over
+        if (!tracePlayer.isPlaying())
+            stopReplay();
+    }
+
+    void Controller::startReplay()
+    {
+        if (solveTrace.totalRecorded() == 0 || !tracePlayer.start(solveStart, solveTrace))
+            return;
+
+        boardView.loadNumbers(solveStart);
+        boardView.loadCandidates(tracePlayer.getCandidates());
+        animationClock.restart();
+    }
+
+    void Controller::stopReplay()
+    {
+        tracePlayer.stop();
+        boardView.loadNumbers(board);
+        boardView.loadCandidates(candidates);
+    }
+
+    void Controller::undo()
+    {
+        std::span<const Sudoku::EditDelta> changes = journal.undo(board);
+        if (!changes.empty())
+            session.recordUndo();
+        applyChanges(changes);
+    }
+
+    void Controller::redo()
+    {
+        std::span<const Sudoku::EditDelta> changes = journal.redo(board);
+        if (!changes.empty())
+            session.recordRedo();
+        applyChanges(changes);
+    }
+
+    void Controller::applyChanges(std::span<const Sudoku::EditDelta> changes)
+    {
+        if (changes.empty())
+            return;
+
+        for (const Sudoku::EditDelta& delta : changes) {
+            candidates.setNumber(delta.row(), delta.col(), board.getNumber(delta.cell));
+            boardView.setNumber(delta.row(), delta.col(), board.getNumber(delta.cell));
+        }
+
+        boardView.loadCandidates(candidates);
+        infoPanel.setCorrectness(isBoardCorrect());
+    }
+
+    bool Controller::isBoardCorrect()
+    {
+        Sudoku::ScopedTimer timer(perfOverlay.slot(PerfOverlay::Section::CORRECTNESS_CHECK));
+        return board.isCorrect();
+    }
+
+    bool Controller::needsRedraw() const
+    {
+        return redrawRequested || boardView.needsRedraw() || infoPanel.needsRedraw() || navbar.needsRedraw() ||
+               perfOverlay.needsRedraw();
+    }
+
+    void Controller::render()
+    {
+        window.clear(WINDOW_BACKGROUND_COLOR);
+        window.draw(boardView);
+        window.draw(infoPanel);
+        window.draw(navbar);
+        window.draw(perfOverlay);
+        window.display();
+
+        if (!firstFrameRendered) {
+            mark_startup_phase("first frame");
+            firstFrameRendered = true;
+        }
+
+        redrawRequested = false;
+        boardView.markDrawn();
+        infoPanel.markDrawn();
+        navbar.markDrawn();
+        perfOverlay.markDrawn();
+    }
+
 }
\ No newline at end of file
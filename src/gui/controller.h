@@ -3,7 +3,14 @@
 #include "boardView.h"
 #include "infoPanel.h"
 #include "navbar.h"
+#include "perfOverlay.h"
+#include "tracePlayer.h"
+#include "../logic/candidates.h"
 #include "../logic/generators.h"
+#include "../logic/journal.h"
+#include "../logic/latency.h"
+#include "../logic/sessionLog.h"
+#include "../logic/satSolver.h"
 
 
 namespace GUI {
@@ -21,18 +28,45 @@ namespace GUI {
 		void run();
 
     private:
+        // Main loop components
+        bool waitEvent(sf::Event& event, sf::Time timeout);     // Returns false if no event arrived before the timeout
+        void handleEvent(const sf::Event& event);
+        bool isAnimating() const { return tracePlayer.isPlaying(); }    // Animated elements require redraws without any user input
+        void updateAnimations();
+        void startReplay();
+        void stopReplay();
+        void undo();
+        void redo();
+        void applyChanges(std::span<const Sudoku::EditDelta> changes);     // Refreshes the fields changed by undo / redo
+        bool isBoardCorrect();                                  // Profiled Board::isCorrect
+        bool needsRedraw() const;
+        void render();
+
         // Backend
         Sudoku::Board board;
         Sudoku::Solver solver;
+        Sudoku::SatSolver satSolver;
         Sudoku::PositionGenerator generator;
-        std::vector<std::tuple<int, int, int, int>> listOfChanges;
+        Sudoku::CandidateMap candidates;
+        Sudoku::EditJournal journal;
+        Sudoku::SessionLog session;                             // Persists the board and its history between the runs
+        Sudoku::LatencyHistogram solveLatencies;
+        Sudoku::LatencyHistogram generateLatencies;
+
+        // Solve replay
+        Sudoku::SolveTrace solveTrace;
+        Sudoku::Board solveStart;                               // The board as it was before the last recorded solve
+        TracePlayer tracePlayer;
+        sf::Clock animationClock;
 
         // Graphic content
-        sf::Image icon;
         sf::RenderWindow window;
         Board boardView;
         InfoPanel infoPanel;
         Navbar navbar;
+        PerfOverlay perfOverlay;
+        bool redrawRequested = true;
+        bool firstFrameRendered = false;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+
+namespace GUI {
+
+    // --------------
+    // Embedded files
+    // --------------
+
+    // Content of the resource directory, compiled into the executable by cmake/EmbedResources.cmake
+    struct EmbeddedFile
+    {
+        const char* name;               // File name relative to the resource directory
+        const unsigned char* data;
+        std::size_t size;
+    };
+
+    extern const EmbeddedFile EMBEDDED_FILES[];
+    extern const std::size_t EMBEDDED_FILE_COUNT;
+
+    const EmbeddedFile* find_embedded_file(std::string_view name);     // Returns nullptr if there is no such file
+
+}
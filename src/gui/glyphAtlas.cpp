@@ -0,0 +1,75 @@
+#include "glyphAtlas.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace GUI {
+
+    // Customizable parameters
+    constexpr unsigned ATLAS_GLYPH_PADDING = 2;     // Prevents bleeding of neighbouring glyphs during texture sampling
+
+
+    // ------------------
+    // GlyphAtlas methods
+    // ------------------
+
+    GlyphAtlas::GlyphAtlas(const sf::Font& font, int maxNumber,
+                           unsigned numberFontSize, float numberCellSize,
+                           unsigned pencilFontSize, float pencilCellSize)
+        : maxNumber(maxNumber)
+    {
+        // Every variant occupies a single row of the atlas, so the atlas size can be bounded by glyph sizes
+        unsigned width = 0, height = 0;
+        for (unsigned fontSize : {numberFontSize, pencilFontSize}) {
+            unsigned rowWidth = 0, rowHeight = 0;
+            for (int num = 1; num <= maxNumber; num++) {
+                const sf::Glyph& glyph = font.getGlyph(symbol(num), fontSize, false);
+                rowWidth += static_cast<unsigned>(glyph.textureRect.width) + ATLAS_GLYPH_PADDING;
+                rowHeight = std::max(rowHeight, static_cast<unsigned>(glyph.textureRect.height));
+            }
+            width = std::max(width, rowWidth + ATLAS_GLYPH_PADDING);
+            height += rowHeight + ATLAS_GLYPH_PADDING;
+        }
+        height += ATLAS_GLYPH_PADDING;
+
+        sf::Image atlasImage;
+        atlasImage.create(width, height, sf::Color::Transparent);
+
+        unsigned penX = ATLAS_GLYPH_PADDING, penY = ATLAS_GLYPH_PADDING;
+        renderVariant(atlasImage, font, NUMBER, numberFontSize, numberCellSize, penX, penY);
+        penY += static_cast<unsigned>(std::max_element(entries[NUMBER].begin(), entries[NUMBER].end(), [](const Entry& a, const Entry& b) {
+            return a.textureRect.height < b.textureRect.height;
+        })->textureRect.height) + ATLAS_GLYPH_PADDING;
+        penX = ATLAS_GLYPH_PADDING;
+        renderVariant(atlasImage, font, PENCIL_MARK, pencilFontSize, pencilCellSize, penX, penY);
+
+        texture.loadFromImage(atlasImage);
+        texture.setSmooth(true);
+    }
+
+    void GlyphAtlas::renderVariant(sf::Image& atlasImage, const sf::Font& font, Variant variant, unsigned fontSize, float cellSize,
+                                   unsigned& penX, unsigned penY)
+    {
+        // Make sure all the glyphs are present in the font page before copying it
+        for (int num = 1; num <= maxNumber; num++)
+            font.getGlyph(symbol(num), fontSize, false);
+        const sf::Image fontPage = font.getTexture(fontSize).copyToImage();
+
+        entries[variant].clear();
+        for (int num = 1; num <= maxNumber; num++) {
+            const sf::Glyph& glyph = font.getGlyph(symbol(num), fontSize, false);
+            const sf::IntRect& source = glyph.textureRect;
+
+            atlasImage.copy(fontPage, penX, penY, source);
+
+            Entry entry;
+            entry.textureRect = sf::IntRect(static_cast<int>(penX), static_cast<int>(penY), source.width, source.height);
+            entry.offset = sf::Vector2f(std::floor((cellSize - static_cast<float>(source.width)) / 2.f),
+                                        std::floor((cellSize - static_cast<float>(source.height)) / 2.f));
+            entries[variant].push_back(entry);
+
+            penX += static_cast<unsigned>(source.width) + ATLAS_GLYPH_PADDING;
+        }
+    }
+
+}
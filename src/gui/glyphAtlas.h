@@ -0,0 +1,48 @@
+#pragma once
+
+#include "resource.h"
+#include "../logic/board.h"
+#include <array>
+#include <vector>
+
+
+namespace GUI {
+
+    // ----------------
+    // GlyphAtlas class
+    // ----------------
+
+    // A single texture with all the board symbols pre-rendered at startup.
+    // Every glyph comes with a precomputed offset that centers it inside a cell, so changing a number on the board
+    // is reduced to swapping texture coordinates of a quad.
+    class GlyphAtlas
+    {
+    public:
+        enum Variant : int { NUMBER, PENCIL_MARK, VARIANT_RANGE };
+
+        struct Entry
+        {
+            sf::IntRect textureRect;        // Glyph area inside the atlas texture
+            sf::Vector2f offset;            // Top left corner of the glyph relative to the top left corner of a cell
+        };
+
+        GlyphAtlas(const sf::Font& font, int maxNumber,
+                   unsigned numberFontSize, float numberCellSize,
+                   unsigned pencilFontSize, float pencilCellSize);
+
+        const Entry& getEntry(Variant variant, int num) const { return entries[variant][num - 1]; }
+        const sf::Texture& getTexture() const { return texture; }
+
+        // Character used to display given number
+        static sf::Uint32 symbol(int num) { return sf::Uint32(Sudoku::number_symbol(num)); }
+
+    private:
+        void renderVariant(sf::Image& atlasImage, const sf::Font& font, Variant variant, unsigned fontSize, float cellSize,
+                           unsigned& penX, unsigned penY);
+
+        std::array<std::vector<Entry>, VARIANT_RANGE> entries;
+        sf::Texture texture;
+        const int maxNumber;
+    };
+
+}
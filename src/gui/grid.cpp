@@ -1,4 +1,5 @@
 #include "grid.h"
+#include "resource.h"
 
 
 namespace GUI {
@@ -8,36 +9,41 @@ namespace GUI {
     // ------------
 
     Grid::Grid(float gridSize, float cellSize, float thickness, sf::Color color)
-        : gridSize(gridSize), cellSize(cellSize), thickness(thickness),
+        : lines(sf::Quads), gridSize(gridSize), cellSize(cellSize), thickness(thickness),
           noLines(static_cast<int>(gridSize / cellSize) + 1)
     {
-        // Create vertical lines
-        for (int i = 0; i < noLines; i++) {
-            lines.emplace_back(sf::Vector2f(thickness, gridSize + thickness));
-            lines.back().setFillColor(color);
-        }
+        // Vertical lines occupy the first (4 * noLines) vertices, horizontal lines the remaining ones
+        lines.resize(8 * noLines);
+        for (std::size_t i = 0; i < lines.getVertexCount(); i++)
+            lines[i].color = color;
 
-        // Create horizontal lines
-        for (int i = 0; i < noLines; i++) {
-            lines.emplace_back(sf::Vector2f(gridSize + thickness, thickness));
-            lines.back().setFillColor(color);
-        }
+        arrangeLines();
     }
 
     void Grid::arrangeLines()
     {
         for (int i = 0; i < noLines; i++) {
             // Vertical line
-            lines[i].setPosition(position.x + cellSize * i - thickness / 2, position.y - thickness / 2);
+            setLineQuad(i, sf::Vector2f(position.x + cellSize * i - thickness / 2, position.y - thickness / 2),
+                        sf::Vector2f(thickness, gridSize + thickness));
             // Horizontal line
-            lines[noLines + i].setPosition(position.x - thickness / 2, position.y + cellSize * i - thickness / 2);
+            setLineQuad(noLines + i, sf::Vector2f(position.x - thickness / 2, position.y + cellSize * i - thickness / 2),
+                        sf::Vector2f(gridSize + thickness, thickness));
         }
     }
 
+    void Grid::setLineQuad(int index, sf::Vector2f pos, sf::Vector2f size)
+    {
+        sf::Vertex* quad = &lines[4 * index];
+        quad[0].position = pos;
+        quad[1].position = sf::Vector2f(pos.x + size.x, pos.y);
+        quad[2].position = sf::Vector2f(pos.x + size.x, pos.y + size.y);
+        quad[3].position = sf::Vector2f(pos.x, pos.y + size.y);
+    }
+
     void Grid::draw(sf::RenderTarget& target, sf::RenderStates states) const
     {
-        for (const sf::RectangleShape& line : lines)
-            target.draw(line, states);
+        draw_primitive(target, lines, states);
     }
 
-}
\ No newline at end of file
+}
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
-#include <vector>
 
 
 namespace GUI {
@@ -10,6 +9,7 @@ namespace GUI {
     // Grid class
     // ----------
 
+    // All the lines are stored as quads inside a single vertex array, so the whole grid is drawn with one draw call
     class Grid : public sf::Drawable
     {
     public:
@@ -22,9 +22,10 @@ namespace GUI {
 
     private:
         void arrangeLines();
+        void setLineQuad(int index, sf::Vector2f pos, sf::Vector2f size);
 
         // Graphic content
-        std::vector<sf::RectangleShape> lines;
+        sf::VertexArray lines;
 
         // Grid parameters
         sf::Vector2f position = {0, 0};      // Top left corner of grid
@@ -34,4 +35,4 @@ namespace GUI {
         const int noLines;                   // Number of lines in one dimension. Total number of lines equals to (2 * noLines).
     };
 
-}
\ No newline at end of file
+}
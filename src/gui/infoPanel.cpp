@@ -4,6 +4,10 @@
 namespace GUI {
 
     const float FONT_SCALE_FACTOR = 1.0f;
+    const float LATENCY_FONT_RATIO = 0.46f;         // Latency table uses smaller font than the labels
+    const float LATENCY_LABEL_WIDTH = 2.8f;         // Widths of the table columns, relative to its font size
+    const float LATENCY_COLUMN_WIDTH = 3.8f;
+    const float LATENCY_ROW_HEIGHT = 1.5f;
 
 
     // -----------------
@@ -23,6 +27,19 @@ namespace GUI {
         solveTimeLabel.setFillColor(sf::Color::Black);
         updateSolveLabel();
 
+        const char* headers[LATENCY_ROWS][LATENCY_COLUMNS] = {
+            { "", "p50", "p90", "p99", "max" }, { "solve", "-", "-", "-", "-" }, { "gen", "-", "-", "-", "-" }
+        };
+        for (int row = 0; row < LATENCY_ROWS; row++) {
+            for (int col = 0; col < LATENCY_COLUMNS; col++) {
+                sf::Text& cell = latencyTable[row][col];
+                cell.setFont(get_font(Resource::MAIN_FONT));
+                cell.setCharacterSize(static_cast<unsigned>(LATENCY_FONT_RATIO * fontSize));
+                cell.setFillColor(row == 0 || col == 0 ? sf::Color(90, 90, 90) : sf::Color::Black);
+                cell.setString(headers[row][col]);
+            }
+        }
+
         const sf::Texture& checkIconTexture = get_texture(Resource::GREEN_CHECK_ICON);
         float scaleFactor = FONT_SCALE_FACTOR * fontSize / checkIconTexture.getSize().x;
         correctIcon.setTexture(checkIconTexture);
@@ -41,10 +58,24 @@ namespace GUI {
     void InfoPanel::updateSolveLabel()
     {
         std::string label = "Solve time: ";
-        if (solveTime >= 0)
-            label += std::to_string(solveTime) + " ms";
-        
+        if (solveTime.count() >= 0)
+            label += Sudoku::format_latency(solveTime);
+
         solveTimeLabel.setString(label);
+        redrawPending = true;
+    }
+
+    void InfoPanel::setLatencies(const Sudoku::LatencyHistogram::Summary& solve, const Sudoku::LatencyHistogram::Summary& generate)
+    {
+        const Sudoku::LatencyHistogram::Summary* summaries[] = { &solve, &generate };
+        for (int row = 1; row < LATENCY_ROWS; row++) {
+            const Sudoku::LatencyHistogram::Summary& summary = *summaries[row - 1];
+            std::chrono::nanoseconds values[] = { summary.p50, summary.p90, summary.p99, summary.max };
+            for (int col = 1; col < LATENCY_COLUMNS; col++)
+                latencyTable[row][col].setString(summary.samples > 0 ? Sudoku::format_latency(values[col - 1]) : "-");
+        }
+
+        redrawPending = true;
     }
 
     void InfoPanel::alignElements()
@@ -56,13 +87,27 @@ namespace GUI {
                                   position.y + correctnessLabel.getLocalBounds().height / 2 + correctnessLabel.getLocalBounds().top);
 
         solveTimeLabel.setPosition(position.x, position.y + correctnessLabel.getLocalBounds().height + rankSpacing);
+
+        float fontSize = static_cast<float>(latencyTable[0][0].getCharacterSize());
+        float tableTop = solveTimeLabel.getPosition().y + 2 * rankSpacing;
+        for (int row = 0; row < LATENCY_ROWS; row++) {
+            for (int col = 0; col < LATENCY_COLUMNS; col++) {
+                float x = col == 0 ? 0.f : fontSize * (LATENCY_LABEL_WIDTH + LATENCY_COLUMN_WIDTH * (col - 1));
+                latencyTable[row][col].setPosition(position.x + x, tableTop + fontSize * LATENCY_ROW_HEIGHT * row);
+            }
+        }
+        redrawPending = true;
     }
 
     void InfoPanel::draw(sf::RenderTarget& target, sf::RenderStates states) const
     {
-        target.draw(correctnessLabel, states);
-        target.draw(solveTimeLabel, states);
-        target.draw(correctness ? correctIcon : incorrectIcon, states);
+        draw_primitive(target, correctnessLabel, states);
+        draw_primitive(target, solveTimeLabel, states);
+        for (const auto& row : latencyTable) {
+            for (const sf::Text& cell : row)
+                draw_primitive(target, cell, states);
+        }
+        draw_primitive(target, correctness ? correctIcon : incorrectIcon, states);
     }
 
 }
\ No newline at end of file
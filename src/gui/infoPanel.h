@@ -1,6 +1,8 @@
 #pragma once
 
 #include "resource.h"
+#include "../logic/latency.h"
+#include <array>
 
 
 namespace GUI {
@@ -14,28 +16,39 @@ namespace GUI {
     public:
         InfoPanel(unsigned fontSize, float iconSpacing, float rankSpacing);
 
-        void setCorrectness(bool correct) { correctness = correct; }
-        void setSolveTime(int time) { solveTime = time; updateSolveLabel(); }
+        void setCorrectness(bool correct) { redrawPending |= correctness != correct; correctness = correct; }
+        void setSolveTime(std::chrono::nanoseconds time) { solveTime = time; updateSolveLabel(); }
+        void setLatencies(const Sudoku::LatencyHistogram::Summary& solve, const Sudoku::LatencyHistogram::Summary& generate);
 
         void setPosition(sf::Vector2f pos) { position = pos; alignElements(); }
         sf::Vector2f getPosition() const { return position; }
 
+        // Redraw tracking
+        bool needsRedraw() const { return redrawPending; }
+        void markDrawn() { redrawPending = false; }
+
         void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
     private:
         void updateSolveLabel();
         void alignElements();
 
+        // Latency table - a header and a row per operation, with p50, p90, p99 and max columns
+        static constexpr int LATENCY_ROWS = 3;
+        static constexpr int LATENCY_COLUMNS = 5;
+
         // Graphic content
         sf::Text correctnessLabel;
         sf::Text solveTimeLabel;
+        std::array<std::array<sf::Text, LATENCY_COLUMNS>, LATENCY_ROWS> latencyTable;
         sf::Sprite correctIcon;
         sf::Sprite incorrectIcon;
 
         // Logic
         sf::Vector2f position;
         bool correctness = true;
-        int solveTime = -1;
+        std::chrono::nanoseconds solveTime{-1};
+        bool redrawPending = true;
 
         const float iconSpacing;
         const float rankSpacing;
@@ -1,4 +1,5 @@
 #include "navbar.h"
+#include <algorithm>
 
 
 namespace GUI {
@@ -45,6 +46,17 @@ namespace GUI {
 		return result;
 	}
 
+	bool Navbar::needsRedraw() const
+	{
+		return std::any_of(buttons.begin(), buttons.end(), [](const auto& buttonInfo) { return buttonInfo.first.needsRedraw(); });
+	}
+
+	void Navbar::markDrawn()
+	{
+		for (auto& buttonInfo : buttons)
+			buttonInfo.first.markDrawn();
+	}
+
 	void Navbar::draw(sf::RenderTarget& target, sf::RenderStates states) const
 	{
 		for (const auto& buttonInfo : buttons)
@@ -25,6 +25,10 @@ namespace GUI {
 		// Main state update, returns the clicked button (if any)
 		ButtonType update(const sf::Event& event);
 
+		// Redraw tracking - true if any of the buttons has changed its appearance
+		bool needsRedraw() const;
+		void markDrawn();
+
 		// Draw
 		void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
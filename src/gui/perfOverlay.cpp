@@ -0,0 +1,81 @@
+#include "perfOverlay.h"
+
+
+namespace GUI {
+
+    const std::size_t FRAME_HISTORY = 120;                     // Frames included in the percentiles
+    const sf::Color OVERLAY_BACKGROUND_COLOR = sf::Color(255, 255, 255, 215);
+    const sf::Color OVERLAY_TEXT_COLOR = sf::Color(40, 40, 40);
+
+
+    // -------------------
+    // PerfOverlay methods
+    // -------------------
+
+    PerfOverlay::PerfOverlay(unsigned fontSize, float padding)
+        : frameTimes(FRAME_HISTORY), padding(padding)
+    {
+        text.setFont(get_font(Resource::MAIN_FONT));
+        text.setCharacterSize(fontSize);
+        text.setFillColor(OVERLAY_TEXT_COLOR);
+        text.setString("Waiting for the next frame...");
+
+        background.setFillColor(OVERLAY_BACKGROUND_COLOR);
+        alignElements();
+    }
+
+    void PerfOverlay::toggle()
+    {
+        visible = !visible;
+        redrawPending = true;
+
+        // Draw calls of the frames rendered without the overlay are not interesting
+        take_draw_call_count();
+        for (Sudoku::ProfileSlot& section : frame)
+            section.reset();
+    }
+
+    void PerfOverlay::endFrame()
+    {
+        long drawCalls = take_draw_call_count();
+        if (!visible)
+            return;
+
+        frameTimes.record(sectionTime(Section::FRAME));
+        Sudoku::LatencyHistogram::Summary recent = frameTimes.summary();
+
+        auto section = [this](Section section) {
+            const Sudoku::ProfileSlot& slot = frame[int(section)];
+            return Sudoku::format_latency(slot.time) + " (" + std::to_string(slot.calls) + "x)";
+        };
+        text.setString("frame   " + Sudoku::format_latency(sectionTime(Section::FRAME)) +
+                       "    p99 " + Sudoku::format_latency(recent.p99) + "    max " + Sudoku::format_latency(recent.max) +
+                       "\nevents  " + Sudoku::format_latency(sectionTime(Section::EVENTS)) +
+                       "    render " + Sudoku::format_latency(sectionTime(Section::RENDER)) +
+                       "    draws " + std::to_string(drawCalls) +
+                       "\nboard   " + section(Section::BOARD_UPDATE) + "    navbar " + section(Section::NAVBAR_UPDATE) +
+                       "\ncheck   " + section(Section::CORRECTNESS_CHECK));
+        alignElements();
+
+        for (Sudoku::ProfileSlot& slot : frame)
+            slot.reset();
+    }
+
+    void PerfOverlay::alignElements()
+    {
+        sf::FloatRect bounds = text.getLocalBounds();
+        background.setPosition(position);
+        background.setSize(sf::Vector2f(bounds.left + bounds.width + 2 * padding, bounds.top + bounds.height + 2 * padding));
+        text.setPosition(position.x + padding, position.y + padding);
+    }
+
+    void PerfOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const
+    {
+        if (!visible)
+            return;
+
+        draw_primitive(target, background, states);
+        draw_primitive(target, text, states);
+    }
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "resource.h"
+#include "../logic/profiler.h"
+#include <array>
+
+
+namespace GUI {
+
+    // -----------------
+    // PerfOverlay class
+    // -----------------
+
+    // Toggleable panel with the timings of the last rendered frame: total frame time (without the idle waiting),
+    // its split into event handling and rendering, draw calls and the time spent in the profiled sections.
+    // Sections are timed only while the overlay is visible - otherwise the timers are disabled.
+    class PerfOverlay : public sf::Drawable
+    {
+    public:
+        enum class Section : int {
+            FRAME,
+            EVENTS,
+            RENDER,
+            BOARD_UPDATE,           // GUI::Board::update
+            NAVBAR_UPDATE,          // Navbar::update
+            CORRECTNESS_CHECK,      // Sudoku::Board::isCorrect
+
+            SECTION_RANGE
+        };
+
+        PerfOverlay(unsigned fontSize, float padding);
+
+        void toggle();
+        bool isVisible() const { return visible; }
+
+        // Timer slot of the section for the current frame, or nullptr if the overlay is hidden
+        Sudoku::ProfileSlot* slot(Section section) { return visible ? &frame[int(section)] : nullptr; }
+
+        // Closes the current frame - its timings are shown with the next redraw (which does not happen just because of them)
+        void endFrame();
+
+        void setPosition(sf::Vector2f pos) { position = pos; alignElements(); }
+        sf::Vector2f getPosition() const { return position; }
+
+        // Redraw tracking
+        bool needsRedraw() const { return redrawPending; }
+        void markDrawn() { redrawPending = false; }
+
+        void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    private:
+        static constexpr int SECTION_COUNT = int(Section::SECTION_RANGE);
+
+        void alignElements();
+        std::chrono::nanoseconds sectionTime(Section section) const { return frame[int(section)].time; }
+
+        // Graphic content
+        sf::RectangleShape background;
+        sf::Text text;
+
+        // Logic
+        std::array<Sudoku::ProfileSlot, SECTION_COUNT> frame;
+        Sudoku::LatencyHistogram frameTimes;        // Recent frames, to expose the spikes hidden by the last one
+        sf::Vector2f position;
+        bool visible = false;
+        bool redrawPending = false;
+
+        const float padding;
+    };
+
+}
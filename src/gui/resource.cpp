@@ -1,8 +1,9 @@
 #include "resource.h"
 #include "button.h"
-#include <iostream>
-#include <exception>
+#include "embedded.h"
+#include <future>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 
@@ -10,18 +11,21 @@
 namespace GUI {
 
     // --------------
-    // Resource paths
+    // Resource files
     // --------------
 
-    const std::string RESOURCE_ROOT = std::string(PROJECT_ROOT) + "/resource/";
-
-    const std::string TILE_FONT_PATH = RESOURCE_ROOT + "coolvetica rg.otf";
-    const std::string BACK_ICON = RESOURCE_ROOT + "back-arrow.png";
-    const std::string CLEAR_ICON = RESOURCE_ROOT + "reset.png";
-    const std::string GENERATE_ICON = RESOURCE_ROOT + "sudoku-2.png";
-    const std::string SOLVE_ICON = RESOURCE_ROOT + "check-symbol.png";
-    const std::string CHECK_ICON = RESOURCE_ROOT + "check.png";
-    const std::string X_ICON = RESOURCE_ROOT + "remove.png";
+    // All the files are embedded into the executable at build time, so the paths are relative to the resource directory
+    const std::string TILE_FONT_FILE = "coolvetica rg.otf";
+
+    const std::pair<Resource, std::string> IMAGE_FILES[] = {
+        {Resource::BACK_BUTTON_ICON, "back-arrow.png"},
+        {Resource::CLEAR_BUTTON_ICON, "reset.png"},
+        {Resource::GENERATE_BUTTON_ICON, "sudoku-2.png"},
+        {Resource::SOLVE_BUTTON_ICON, "check-symbol.png"},
+        {Resource::GREEN_CHECK_ICON, "check.png"},
+        {Resource::RED_X_ICON, "remove.png"},
+        {Resource::WINDOW_ICON, "sudoku.png"}
+    };
 
     constexpr Resource BUTTON_MAPPING[int(ButtonType::BUTTON_TYPE_RANGE)] = {
         Resource::NONE, Resource::BACK_BUTTON_ICON, Resource::CLEAR_BUTTON_ICON, Resource::GENERATE_BUTTON_ICON,
@@ -36,36 +40,61 @@ namespace GUI {
     bool loaded = false;
 
     std::unordered_map<Resource, std::unique_ptr<sf::Font>> fonts;
+    std::unordered_map<Resource, std::future<std::unique_ptr<sf::Image>>> pendingImages;
+    std::unordered_map<Resource, std::unique_ptr<sf::Image>> images;
     std::unordered_map<Resource, std::unique_ptr<sf::Texture>> textures;
 
 
+    // --------------
+    // Embedded files
+    // --------------
+
+    const EmbeddedFile* find_embedded_file(std::string_view name)
+    {
+        for (std::size_t i = 0; i < EMBEDDED_FILE_COUNT; i++) {
+            if (name == EMBEDDED_FILES[i].name)
+                return &EMBEDDED_FILES[i];
+        }
+
+        return nullptr;
+    }
+
+    const EmbeddedFile& get_embedded_file(const std::string& name)
+    {
+        const EmbeddedFile* file = find_embedded_file(name);
+        if (file == nullptr)
+            throw std::invalid_argument("Resource file " + name + " has not been embedded");
+
+        return *file;
+    }
+
+
     // ----------------
     // Resource loading
     // ----------------
 
-    // Load given texture and check for correctness
-	void load_texture(Resource name, const std::string &path)
-	{
-		textures.insert({name, std::make_unique<sf::Texture>()});
-		if (!textures[name]->loadFromFile(path)) {
-			std::cerr << "Unable to load texture from: " << path << std::endl;
-			exit(EXIT_FAILURE);
-		}
-	}
+    // Image decoding does not require any graphic context, so it can safely run in a background thread
+    std::unique_ptr<sf::Image> decode_image(const EmbeddedFile& file)
+    {
+        std::unique_ptr<sf::Image> image = std::make_unique<sf::Image>();
+        if (!image->loadFromMemory(file.data, file.size))
+            throw std::runtime_error(std::string("Unable to decode image ") + file.name);
+
+        return image;
+    }
 
     void load_resources()
     {
         if (!loaded) {
+            for (const auto& [name, fileName] : IMAGE_FILES)
+                pendingImages.insert({name, std::async(std::launch::async, decode_image, std::cref(get_embedded_file(fileName)))});
+
+            // Glyphs are rasterized on demand, so loading a font only parses its header
+            const EmbeddedFile& fontFile = get_embedded_file(TILE_FONT_FILE);
             std::unique_ptr<sf::Font> tileFont = std::make_unique<sf::Font>();
-            tileFont->loadFromFile(TILE_FONT_PATH);
+            if (!tileFont->loadFromMemory(fontFile.data, fontFile.size))
+                throw std::runtime_error("Unable to load font " + TILE_FONT_FILE);
             fonts.insert({Resource::MAIN_FONT, std::move(tileFont)});
-            
-            load_texture(Resource::BACK_BUTTON_ICON, BACK_ICON);
-            load_texture(Resource::CLEAR_BUTTON_ICON, CLEAR_ICON);
-            load_texture(Resource::GENERATE_BUTTON_ICON, GENERATE_ICON);
-            load_texture(Resource::SOLVE_BUTTON_ICON, SOLVE_ICON);
-            load_texture(Resource::GREEN_CHECK_ICON, CHECK_ICON);
-            load_texture(Resource::RED_X_ICON, X_ICON);
 
             loaded = true;
         }
@@ -79,10 +108,29 @@ namespace GUI {
         return *fonts[fontName];
     }
 
+    const sf::Image& get_image(Resource imageName)
+    {
+        // Finish decoding on first use
+        if (!images.contains(imageName) && pendingImages.contains(imageName)) {
+            images.insert({imageName, pendingImages[imageName].get()});
+            pendingImages.erase(imageName);
+        }
+
+        if (!images.contains(imageName))
+            throw std::invalid_argument("Image with identifier " + std::to_string(int(imageName)) + " not found");
+
+        return *images[imageName];
+    }
+
     const sf::Texture& get_texture(Resource textureName)
     {
-        if (!textures.contains(textureName))
-            throw std::invalid_argument("Texture with identifier " + std::to_string(int(textureName)) + " not found");
+        // Textures are uploaded to GPU on first use
+        if (!textures.contains(textureName)) {
+            std::unique_ptr<sf::Texture> texture = std::make_unique<sf::Texture>();
+            if (!texture->loadFromImage(get_image(textureName)))
+                throw std::runtime_error("Unable to create texture with identifier " + std::to_string(int(textureName)));
+            textures.insert({textureName, std::move(texture)});
+        }
 
         return *textures[textureName];
     }
@@ -92,4 +140,45 @@ namespace GUI {
         return get_texture(BUTTON_MAPPING[int(bType)]);
     }
 
-}
\ No newline at end of file
+
+    // ------------------------
+    // Startup time measurement
+    // ------------------------
+
+    // Initialized together with other globals, before main() is entered
+    const std::chrono::steady_clock::time_point PROGRAM_START = std::chrono::steady_clock::now();
+
+    StartupHook startupHook;
+
+    void set_startup_hook(StartupHook hook)
+    {
+        startupHook = std::move(hook);
+    }
+
+    void mark_startup_phase(const std::string& phase)
+    {
+        if (startupHook)
+            startupHook(phase, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - PROGRAM_START));
+    }
+
+
+    // ------------------
+    // Draw call counting
+    // ------------------
+
+    long drawCallCount = 0;         // Rendering happens only on the main thread
+
+    void draw_primitive(sf::RenderTarget& target, const sf::Drawable& primitive, const sf::RenderStates& states)
+    {
+        target.draw(primitive, states);
+        drawCallCount++;
+    }
+
+    long take_draw_call_count()
+    {
+        long count = drawCallCount;
+        drawCallCount = 0;
+        return count;
+    }
+
+}
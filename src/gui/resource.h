@@ -3,6 +3,9 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
+#include <chrono>
+#include <functional>
+#include <string>
 
 
 namespace GUI {
@@ -25,6 +28,8 @@ namespace GUI {
         GREEN_CHECK_ICON,
         RED_X_ICON,
 
+        WINDOW_ICON,
+
         NONE = 0
     };
 
@@ -33,12 +38,33 @@ namespace GUI {
     // Resource loading
     // ----------------
 
-    extern const std::string RESOURCE_ROOT;
-
+    // Starts decoding of all the embedded images in background threads
+    // Images and textures are then finalized lazily, on first use
     void load_resources();
 
     const sf::Font& get_font(Resource fontName);
+    const sf::Image& get_image(Resource imageName);
     const sf::Texture& get_texture(Resource textureName);
     const sf::Texture& get_texture(ButtonType bType);
+
+
+    // ------------------------
+    // Startup time measurement
+    // ------------------------
+
+    using StartupHook = std::function<void(const std::string& phase, std::chrono::microseconds sinceStart)>;
+
+    void set_startup_hook(StartupHook hook);
+    void mark_startup_phase(const std::string& phase);      // Reports the time elapsed since program start to the hook (if set)
+
+
+    // ------------------
+    // Draw call counting
+    // ------------------
+
+    // GUI elements draw their primitives (texts, sprites, shapes and vertex arrays) through draw_primitive,
+    // so that the number of draw calls issued per frame can be shown by the performance overlay
+    void draw_primitive(sf::RenderTarget& target, const sf::Drawable& primitive, const sf::RenderStates& states);
+    long take_draw_call_count();        // Returns the number of primitives drawn since the previous call
     
-}
\ No newline at end of file
+}
@@ -7,35 +7,69 @@ namespace GUI {
     // Tile methods
     // ------------
 
-    Tile::Tile()
-        : background(sf::Vector2(0.f, 0.f))
+    Tile::Tile(float tileSize)
+        : tileSize(tileSize)
     {
     }
 
-    Tile::Tile(float tileSize, unsigned fontSize)
-        : background(sf::Vector2f(tileSize, tileSize))
+    void Tile::buildBackgroundQuad(sf::Vertex* quad) const
     {
-        text.setFont(get_font(Resource::MAIN_FONT));
-        text.setCharacterSize(fontSize);
+        quad[0].position = position;
+        quad[1].position = sf::Vector2f(position.x + tileSize, position.y);
+        quad[2].position = sf::Vector2f(position.x + tileSize, position.y + tileSize);
+        quad[3].position = sf::Vector2f(position.x, position.y + tileSize);
 
-        alignElements();
-        setText();
-        setTextColor(sf::Color::Black);
+        for (int i = 0; i < 4; i++)
+            quad[i].color = backgroundColor;
     }
 
-    void Tile::alignElements()
+    void Tile::buildTextQuad(sf::Vertex* quad, const GlyphAtlas& atlas) const
     {
-        background.setPosition(position);
-        text.setPosition(sf::Vector2f(
-            position.x + background.getGlobalBounds().width / 2.f - text.getLocalBounds().width / 2.f,
-            position.y + background.getGlobalBounds().height / 2.f - text.getLocalBounds().height / 2.f - text.getLocalBounds().top
-        ));
+        if (num == 0)
+            buildEmptyQuad(quad);
+        else
+            buildGlyphQuad(quad, atlas.getEntry(GlyphAtlas::NUMBER, num), position, textColor);
     }
 
-    void Tile::draw(sf::RenderTarget& target, sf::RenderStates states) const
+    void Tile::buildPencilQuads(sf::Vertex* quads, const GlyphAtlas& atlas) const
     {
-        target.draw(background, states);
-        target.draw(text, states);
+        // Candidates are arranged in a mini-grid with the same layout as inner squares of the board
+        const float cellSize = tileSize / Sudoku::INNER_SQUARE_SIZE;
+
+        for (int n = 1; n <= Sudoku::BOARD_SIZE; n++) {
+            sf::Vertex* quad = quads + 4 * (n - 1);
+            if (num != 0 || !(candidates & Sudoku::candidate_bit(n))) {
+                buildEmptyQuad(quad);
+                continue;
+            }
+
+            sf::Vector2f cellPos = {position.x + cellSize * ((n - 1) % Sudoku::INNER_SQUARE_SIZE),
+                                    position.y + cellSize * ((n - 1) / Sudoku::INNER_SQUARE_SIZE)};
+            buildGlyphQuad(quad, atlas.getEntry(GlyphAtlas::PENCIL_MARK, n), cellPos, pencilMarkColor);
+        }
+    }
+
+    void Tile::buildEmptyQuad(sf::Vertex* quad) const
+    {
+        for (int i = 0; i < 4; i++)
+            quad[i] = sf::Vertex(position, sf::Color::Transparent);
+    }
+
+    void Tile::buildGlyphQuad(sf::Vertex* quad, const GlyphAtlas::Entry& entry, sf::Vector2f cellPos, sf::Color color) const
+    {
+        // Pre-rendered glyphs are already centered, so it's just a matter of copying the atlas entry
+        const sf::IntRect& rect = entry.textureRect;
+
+        float left = cellPos.x + entry.offset.x, top = cellPos.y + entry.offset.y;
+        float right = left + static_cast<float>(rect.width), bottom = top + static_cast<float>(rect.height);
+
+        float u0 = static_cast<float>(rect.left), v0 = static_cast<float>(rect.top);
+        float u1 = u0 + static_cast<float>(rect.width), v1 = v0 + static_cast<float>(rect.height);
+
+        quad[0] = sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0));
+        quad[1] = sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0));
+        quad[2] = sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1));
+        quad[3] = sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1));
     }
 
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "resource.h"
+#include "glyphAtlas.h"
+#include "../logic/candidates.h"
 
 
 namespace GUI {
@@ -9,38 +10,48 @@ namespace GUI {
     // Tile class
     // ----------
 
-    class Tile : public sf::Drawable
+    // Tiles are not drawn on their own - they only describe the content of a single board field,
+    // which is then batched by the board view into shared vertex arrays
+    class Tile
     {
     public:
-        Tile();
-        Tile(float tileSize, unsigned fontSize);
+        Tile() = default;
+        Tile(float tileSize);
         Tile(const Tile& other) = default;
         Tile& operator=(const Tile& other) = default;
 
-        void setNumber(int n) { num = n; setText(); }
-        void removeNumber() { num = 0; setText(); }
+        void setNumber(int n) { num = n; }
+        void removeNumber() { num = 0; }
         int getNumber() const { return num; }
 
-        void setPosition(sf::Vector2f pos) { position = pos; alignElements(); }
+        void setCandidates(Sudoku::CandidateMask mask) { candidates = mask; }
+        Sudoku::CandidateMask getCandidates() const { return candidates; }
+
+        void setPosition(sf::Vector2f pos) { position = pos; }
         sf::Vector2f getPosition() const { return position; }
-        sf::FloatRect getGlobalBounds() const { return background.getGlobalBounds(); }
+        sf::FloatRect getGlobalBounds() const { return sf::FloatRect(position, sf::Vector2f(tileSize, tileSize)); }
 
-        void setBackgroundColor(sf::Color color) { background.setFillColor(color); }
-        void setTextColor(sf::Color color) { text.setFillColor(color); }
+        void setBackgroundColor(sf::Color color) { backgroundColor = color; }
+        void setTextColor(sf::Color color) { textColor = color; }
+        void setPencilMarkColor(sf::Color color) { pencilMarkColor = color; }
 
-        void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+        // Mesh generation - each method fills exactly 4 vertices of a quad
+        void buildBackgroundQuad(sf::Vertex* quad) const;
+        void buildTextQuad(sf::Vertex* quad, const GlyphAtlas& atlas) const;    // An empty tile produces a degenerate quad
+        void buildPencilQuads(sf::Vertex* quads, const GlyphAtlas& atlas) const;   // Fills BOARD_SIZE quads, one per candidate
 
     private:
-        void alignElements();
-        void setText() { text.setString(num != 0 ? std::to_string(num) : ""); alignElements(); }
-
-        // Graphic content
-        sf::RectangleShape background;
-        sf::Text text;
+        void buildEmptyQuad(sf::Vertex* quad) const;
+        void buildGlyphQuad(sf::Vertex* quad, const GlyphAtlas::Entry& entry, sf::Vector2f cellPos, sf::Color color) const;
 
         // Tile parameters
         sf::Vector2f position = {0, 0};      // Top left corner
-        int num = 0;                         // A number shown by 'text' element
+        sf::Color backgroundColor = sf::Color::White;
+        sf::Color textColor = sf::Color::Black;
+        sf::Color pencilMarkColor = sf::Color::Black;
+        float tileSize = 0.f;
+        int num = 0;                         // A number shown on the tile
+        Sudoku::CandidateMask candidates = 0;   // Pencil marks, shown only if the tile is empty
     };
 
-}
\ No newline at end of file
+}
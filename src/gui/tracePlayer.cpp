@@ -0,0 +1,81 @@
+#include "tracePlayer.h"
+
+
+namespace GUI {
+
+    // -------------------
+    // TracePlayer methods
+    // -------------------
+
+    TracePlayer::TracePlayer(sf::Time stepTime)
+        : stepTime(stepTime)
+    {
+        guessStack.reserve(Sudoku::BOARD_SIZE * Sudoku::BOARD_SIZE);
+    }
+
+    bool TracePlayer::start(const Sudoku::Board& initialBoard, const Sudoku::SolveTrace& trace)
+    {
+        if (!trace.isComplete())
+            return false;
+
+        board = initialBoard;
+        candidates.load(board);
+        guessStack.clear();
+
+        // The events are copied, so that the trace can be safely reused by the solver during the replay
+        events.resize(trace.size());
+        for (std::size_t i = 0; i < trace.size(); i++)
+            events[i] = trace[i];
+
+        nextEvent = 0;
+        pendingTime = sf::Time::Zero;
+        playing = !events.empty();
+
+        return true;
+    }
+
+    bool TracePlayer::advance(sf::Time elapsed)
+    {
+        if (!playing)
+            return false;
+
+        bool changed = false;
+        for (pendingTime += elapsed; pendingTime >= stepTime && nextEvent < events.size(); pendingTime -= stepTime) {
+            // Apply the leading event together with all the eliminations that follow it
+            do {
+                applyEvent(events[nextEvent++]);
+            } while (nextEvent < events.size() && events[nextEvent].type() == Sudoku::TraceEventType::ELIMINATION);
+
+            changed = true;
+        }
+
+        playing = nextEvent < events.size();
+        return changed;
+    }
+
+    void TracePlayer::applyEvent(const Sudoku::TraceEvent& event)
+    {
+        int r = event.row(), c = event.col(), num = event.number;
+
+        switch (event.type()) {
+            case Sudoku::TraceEventType::GUESS:
+                guessStack.emplace_back(board, candidates);
+                [[fallthrough]];
+            case Sudoku::TraceEventType::PLACEMENT:
+                board.setNumber(r, c, num);
+                candidates.setNumber(r, c, num);
+                break;
+            case Sudoku::TraceEventType::ELIMINATION:
+                candidates.eliminate(r, c, num);
+                break;
+            case Sudoku::TraceEventType::BACKTRACK:
+                if (!guessStack.empty()) {
+                    board = guessStack.back().first;
+                    candidates = guessStack.back().second;
+                    guessStack.pop_back();
+                }
+                break;
+        }
+    }
+
+}
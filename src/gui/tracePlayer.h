@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../logic/candidates.h"
+#include "../logic/trace.h"
+#include <SFML/System.hpp>
+#include <vector>
+
+
+namespace GUI {
+
+    // -----------------
+    // TracePlayer class
+    // -----------------
+
+    // Replays a recorded solve step by step. A single step consists of a placement, guess or backtrack,
+    // together with all the eliminations that follow it.
+    class TracePlayer
+    {
+    public:
+        TracePlayer(sf::Time stepTime);
+
+        // Returns false if the trace does not contain the entire solve (some events have been overwritten)
+        bool start(const Sudoku::Board& initialBoard, const Sudoku::SolveTrace& trace);
+        void stop() { playing = false; }
+        bool isPlaying() const { return playing; }
+
+        // Returns true if the replayed state has changed
+        bool advance(sf::Time elapsed);
+
+        const Sudoku::Board& getBoard() const { return board; }
+        const Sudoku::CandidateMap& getCandidates() const { return candidates; }
+
+    private:
+        void applyEvent(const Sudoku::TraceEvent& event);
+
+        // Replayed state
+        Sudoku::Board board;
+        Sudoku::CandidateMap candidates;
+        std::vector<std::pair<Sudoku::Board, Sudoku::CandidateMap>> guessStack;     // States from before every active guess
+
+        // Playback
+        std::vector<Sudoku::TraceEvent> events;
+        std::size_t nextEvent = 0;
+        sf::Time pendingTime;
+        bool playing = false;
+
+        const sf::Time stepTime;
+    };
+
+}
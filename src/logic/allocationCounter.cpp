@@ -0,0 +1,45 @@
+#include "allocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+
+namespace Sudoku {
+
+    namespace {
+        thread_local long allocationCount = 0;
+    }
+
+    long thread_allocation_count()
+    {
+        return allocationCount;
+    }
+
+}
+
+
+// -----------------------------
+// Replaced allocation functions
+// -----------------------------
+
+#ifdef SUDOKU_COUNT_ALLOCATIONS
+
+void* operator new(std::size_t size)
+{
+    Sudoku::allocationCount++;
+
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+
+
+namespace Sudoku {
+
+    // ------------------
+    // Allocation counter
+    // ------------------
+
+    // Heap allocations are counted only in builds with SUDOKU_COUNT_ALLOCATIONS defined, which replace the global operator new.
+    // It allows to catch regressions in code meant to be allocation-free, like the solver's search.
+#ifdef SUDOKU_COUNT_ALLOCATIONS
+    constexpr bool ALLOCATION_COUNTING = true;
+#else
+    constexpr bool ALLOCATION_COUNTING = false;
+#endif
+
+    long thread_allocation_count();     // Number of allocations made so far by the calling thread (always 0 if not counting)
+
+}
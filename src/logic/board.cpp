@@ -7,6 +7,37 @@
 
 namespace Sudoku {
 
+    // ----------------
+    // Helper functions
+    // ----------------
+
+    int symbol_number(char sym)
+    {
+        int num = 0;
+        if (sym >= '1' && sym <= '9')
+            num = sym - '0';
+        else if (std::isalpha(static_cast<unsigned char>(sym)))
+            num = std::toupper(static_cast<unsigned char>(sym)) - 'A' + 10;
+
+        return num <= BOARD_SIZE ? num : 0;
+    }
+
+    int field_symbol_value(char sym)
+    {
+        // 'n' stands for null or none (empty field), unless it is a number of the board (23 on 25x25 boards)
+        int num = symbol_number(sym);
+        if (num != 0)
+            return num;
+
+        return sym == '.' || sym == '0' || sym == 'n' || sym == 'N' ? 0 : -1;
+    }
+
+    int field_symbol_count(const std::string& setup)
+    {
+        return static_cast<int>(std::count_if(setup.begin(), setup.end(), [](char sym) { return field_symbol_value(sym) >= 0; }));
+    }
+
+
     // -------------------------------------
     // Board methods - global state handlers
     // -------------------------------------
@@ -18,7 +49,8 @@ namespace Sudoku {
 
     void Board::load(const std::string& setup)
     {
-        // Warning - no support for boards bigger than 9x9
+        // Rows can be either separated with '/' or given one after another, as in the single line format
+        // Fields are given with number symbols or empty field symbols (see field_symbol_value()), other symbols are skipped
 
         clear();
 
@@ -27,14 +59,34 @@ namespace Sudoku {
             if (sym == '/') {
                 r++;
                 c = 0;
+                continue;
             }
-            else if (sym == 'n')    // 'n' stands for null or none (empty field)
-                c++;
-            else if (std::isdigit(sym)) {
-                setNumber(r, c, static_cast<int>(sym - '0'));
-                c++;
+
+            int num = field_symbol_value(sym);
+            if (num < 0)
+                continue;
+
+            if (c == BOARD_SIZE) {
+                r++;
+                c = 0;
             }
+            if (r >= BOARD_SIZE)
+                break;
+
+            setNumber(r, c, num);
+            c++;
+        }
+    }
+
+    std::string Board::toString() const
+    {
+        std::string result(CELL_COUNT, '.');
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (!isEmpty(cell))
+                result[cell] = number_symbol(board[cell]);
         }
+
+        return result;
     }
 
 
@@ -44,29 +96,24 @@ namespace Sudoku {
 
     bool Board::isCorrect() const
     {
-        std::pair<int, std::set<int>> rows[BOARD_SIZE] = {}, cols[BOARD_SIZE] = {}, boxes[BOARD_SIZE] = {};
-
-        // Loop over the entire board
-        for (int r = 0; r < BOARD_SIZE; r++) {
-            for (int c = 0; c < BOARD_SIZE; c++)  {
-                if (!isEmpty(r, c)) {
-                    rows[r].first++;
-                    rows[r].second.insert(board[r][c]);
-                    cols[c].first++;
-                    cols[c].second.insert(board[r][c]);
-                    boxes[innerSquare(r, c)].first++;
-                    boxes[innerSquare(r, c)].second.insert(board[r][c]);
-                }
+        // Bitmasks of numbers present in every row, column and box
+        unsigned rows[BOARD_SIZE] = {}, cols[BOARD_SIZE] = {}, boxes[BOARD_SIZE] = {};
+
+        // Loop over the entire board, any number already present in one of its units is a duplicate
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (!isEmpty(cell)) {
+                unsigned bit = 1u << board[cell];
+                unsigned& row = rows[CELL_ROW[cell]];
+                unsigned& col = cols[CELL_COL[cell]];
+                unsigned& box = boxes[CELL_BOX[cell]];
+                if ((row | col | box) & bit)
+                    return false;
+
+                row |= bit;
+                col |= bit;
+                box |= bit;
             }
         }
-            
-        // std::set does not allow duplicated values, so if every value is unique, they should have size() equal to BOARD_SIZE
-        for (int i = 0 ; i < BOARD_SIZE; i++) {
-            if (rows[i].second.size() < rows[i].first || 
-                cols[i].second.size() < cols[i].first || 
-                boxes[i].second.size() < boxes[i].first)
-                return false;
-        }
 
         return true;
     }
@@ -78,7 +125,7 @@ namespace Sudoku {
             return true;
         
         std::set<int> options = availableNumbers(row, col);
-        return options.find(board[row][col]) != options.end();
+        return options.find(getNumber(row, col)) != options.end();
     }
 
     std::set<int> Board::availableNumbers(int row, int col) const
@@ -86,26 +133,13 @@ namespace Sudoku {
         if (!isEmpty(row, col))
             return {};
 
-        // Warning: needs to be corrected to generalize for all sudoku board sizes
-        std::set<int> allOptions = {1, 2, 3, 4, 5, 6, 7, 8, 9}, illegalOptions = {};
+        std::set<int> allOptions, illegalOptions;
+        for (int num = 1; num <= BOARD_SIZE; num++)
+            allOptions.insert(num);
 
-        // Rows and columns
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            if (i != col)
-                illegalOptions.insert(board[row][i]);
-            if (i != row)
-                illegalOptions.insert(board[i][col]);
-        }
-
-        // Boxes
-        auto [x0, y0] = innerSquareTopLeft(innerSquare(row, col));
-        for (int i = 0; i < INNER_SQUARE_SIZE; i++) {
-            for (int j = 0; j < INNER_SQUARE_SIZE; j++) {
-                int r = x0 + i, c = y0 + j;
-                if (r != row || c != col)
-                    illegalOptions.insert(board[r][c]);
-            }
-        }
+        // Rows, columns and boxes
+        for (int peer : CELL_PEERS[cell_index(row, col)])
+            illegalOptions.insert(board[peer]);
 
         // Calculate and return the difference
         std::set<int> diff;
@@ -124,7 +158,7 @@ namespace Sudoku {
     {
         for (int r = 0; r < BOARD_SIZE; r++) {
             for (int k = 0; k < BOARD_SIZE; k++) {
-                os << board.board[r][k] << " ";
+                os << (board.isEmpty(r, k) ? '0' : number_symbol(board.getNumber(r, k))) << " ";
                 if (k % INNER_SQUARE_SIZE == INNER_SQUARE_SIZE - 1 && k != BOARD_SIZE - 1)
                     os << "| ";
             }
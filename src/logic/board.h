@@ -1,5 +1,6 @@
 #pragma once
 
+#include "geometry.h"
 #include <array>
 #include <iostream>
 #include <set>
@@ -13,11 +14,14 @@ namespace Sudoku {
     // Helper defines
     // --------------
 
-    constexpr int BOARD_SIZE = 9;
-    constexpr int INNER_SQUARE_SIZE = 3;
-
     enum LineType : int { ROW, COL };
 
+    // Numbers are written as digits 1-9, followed by letters for the bigger boards (A for 10, up to P for 25)
+    constexpr char number_symbol(int num) { return num < 10 ? char('0' + num) : char('A' + num - 10); }
+    int symbol_number(char sym);        // Case insensitive, returns 0 for symbols which are not numbers of the board
+    int field_symbol_value(char sym);   // Number of a field symbol, 0 for an empty field ('.', '0' or 'n' if not a number), -1 for other symbols
+    int field_symbol_count(const std::string& setup);   // Fields given by a setup (see Board::load()), '/' and other symbols are not counted
+
 
     // -----------
     // Board class
@@ -30,15 +34,22 @@ namespace Sudoku {
         Board() = default;
         Board(const Board& other) = default;
         Board& operator=(const Board& other) = default;
+        bool operator==(const Board& other) const = default;
 
         // Global state handlers
         void clear();
         void load(const std::string& setup);
+        std::string toString() const;               // Single line of BOARD_SIZE^2 symbols (see number_symbol()), with '.' for empty fields
 
         // Local state handlers
-        void setNumber(int row, int col, int number) { board[row][col] = number; }
-        int getNumber(int row, int col) const { return board[row][col]; }           // Returns a single number
-        bool isEmpty(int row, int col) const { return board[row][col] == 0; }
+        void setNumber(int row, int col, int number) { board[cell_index(row, col)] = number; }
+        int getNumber(int row, int col) const { return board[cell_index(row, col)]; }     // Returns a single number
+        bool isEmpty(int row, int col) const { return board[cell_index(row, col)] == 0; }
+
+        // Same as above, with fields given by their indexes (see cell_index())
+        void setNumber(int cell, int number) { board[cell] = number; }
+        int getNumber(int cell) const { return board[cell]; }
+        bool isEmpty(int cell) const { return board[cell] == 0; }
 
         // Correctness checks
         bool isCorrect() const;                     // Entire board check
@@ -46,15 +57,14 @@ namespace Sudoku {
         std::set<int> availableNumbers(int row, int col) const;
 
         // Inner square calculations
-        static int innerSquare(int row, int col) { return row - row % INNER_SQUARE_SIZE + col / INNER_SQUARE_SIZE; }
-        static std::pair<int, int> innerSquareTopLeft(int isq) { return { isq - isq % INNER_SQUARE_SIZE,
-                                                                         (isq % INNER_SQUARE_SIZE) * INNER_SQUARE_SIZE }; }
+        static int innerSquare(int row, int col) { return CELL_BOX[cell_index(row, col)]; }
+        static std::pair<int, int> innerSquareTopLeft(int isq) { return { CELL_ROW[box_cells(isq)[0]], CELL_COL[box_cells(isq)[0]] }; }
 
         // Helper functions
         friend std::ostream& operator<<(std::ostream& os, const Board& board);
 
     private:
-        std::array<std::array<int, BOARD_SIZE>, BOARD_SIZE> board = { };
+        std::array<int, CELL_COUNT> board = { };        // Fields row by row
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "candidates.h"
+
+
+namespace Sudoku {
+
+    // ---------------------------------------------
+    // CandidateMap methods - global state handlers
+    // ---------------------------------------------
+
+    void CandidateMap::clear()
+    {
+        rowCounts = {};
+        colCounts = {};
+        boxCounts = {};
+        rowUsed = {};
+        colUsed = {};
+        boxUsed = {};
+        numbers = {};
+        eliminated = {};
+
+        for (auto& row : candidates)
+            row.fill(ALL_CANDIDATES);
+    }
+
+    void CandidateMap::load(const Board& board)
+    {
+        clear();
+
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++) {
+                if (!board.isEmpty(r, c))
+                    place(r, c, board.getNumber(r, c), 1);
+            }
+        }
+
+        // A single full pass is cheaper than refreshing the peers of every given number
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++)
+                refresh(r, c);
+        }
+    }
+
+
+    // --------------------------------------------
+    // CandidateMap methods - local state handlers
+    // --------------------------------------------
+
+    void CandidateMap::setNumber(int row, int col, int number)
+    {
+        if (numbers[row][col] == number)
+            return;
+
+        if (numbers[row][col] != 0)
+            place(row, col, numbers[row][col], -1);
+        if (number != 0)
+            place(row, col, number, 1);
+
+        refreshPeers(row, col);
+    }
+
+    void CandidateMap::eliminate(int row, int col, int num)
+    {
+        eliminated[row][col] |= candidate_bit(num);
+        refresh(row, col);
+    }
+
+    void CandidateMap::place(int row, int col, int number, int delta)
+    {
+        int box = CELL_BOX[cell_index(row, col)], i = number - 1;
+
+        rowCounts[row][i] += delta;
+        colCounts[col][i] += delta;
+        boxCounts[box][i] += delta;
+
+        // Keep the used masks in sync with counters
+        rowUsed[row] = rowCounts[row][i] > 0 ? rowUsed[row] | candidate_bit(number) : rowUsed[row] & ~candidate_bit(number);
+        colUsed[col] = colCounts[col][i] > 0 ? colUsed[col] | candidate_bit(number) : colUsed[col] & ~candidate_bit(number);
+        boxUsed[box] = boxCounts[box][i] > 0 ? boxUsed[box] | candidate_bit(number) : boxUsed[box] & ~candidate_bit(number);
+
+        numbers[row][col] = delta > 0 ? number : 0;
+    }
+
+    void CandidateMap::refreshPeers(int row, int col)
+    {
+        int cell = cell_index(row, col);
+        refresh(row, col);
+        for (int peer : CELL_PEERS[cell])
+            refresh(CELL_ROW[peer], CELL_COL[peer]);
+    }
+
+    void CandidateMap::refresh(int row, int col)
+    {
+        candidates[row][col] = numbers[row][col] != 0 ? 0 :
+                               CandidateMask(ALL_CANDIDATES & ~(rowUsed[row] | colUsed[col] | boxUsed[CELL_BOX[cell_index(row, col)]] |
+                                                                eliminated[row][col]));
+    }
+
+}
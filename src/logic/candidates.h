@@ -0,0 +1,65 @@
+#pragma once
+
+#include "board.h"
+#include <bit>
+#include <cstdint>
+
+
+namespace Sudoku {
+
+    // ---------------
+    // Candidate masks
+    // ---------------
+
+    // Bit (num - 1) stands for num - 16x16 boards still fit into 16 bits, 25x25 ones require 32
+    using CandidateMask = std::conditional_t<BOARD_SIZE <= 16, std::uint16_t, std::uint32_t>;
+
+    constexpr CandidateMask ALL_CANDIDATES = (1 << BOARD_SIZE) - 1;
+
+    constexpr CandidateMask candidate_bit(int num) { return CandidateMask(1 << (num - 1)); }
+    constexpr int lowest_candidate(CandidateMask mask) { return std::countr_zero(mask) + 1; }     // Mask must not be empty
+    constexpr int candidate_count(CandidateMask mask) { return std::popcount(mask); }
+
+    using Possibilities = std::array<CandidateMask, CELL_COUNT>;    // Candidates of every field
+
+
+    // ------------------
+    // CandidateMap class
+    // ------------------
+
+    // Incrementally maintained set of candidates of every field of the board.
+    // Placing or removing a number only touches the row, column and box peers of the changed field.
+    class CandidateMap
+    {
+    public:
+        CandidateMap() { clear(); }
+
+        // Global state handlers
+        void clear();
+        void load(const Board& board);
+
+        // Local state handlers
+        void setNumber(int row, int col, int number);       // Number 0 removes the previous number from the field
+        void eliminate(int row, int col, int num);          // Removes a candidate that is not excluded by the peers (until the next clear)
+        CandidateMask getCandidates(int row, int col) const { return candidates[row][col]; }   // Always empty for filled fields
+        bool isCandidate(int row, int col, int num) const { return candidates[row][col] & candidate_bit(num); }
+
+    private:
+        void place(int row, int col, int number, int delta);
+        void refreshPeers(int row, int col);
+        void refresh(int row, int col);
+
+        // Each unit counts the occurences of every number, so that removing a duplicated number keeps the other one effective
+        std::array<std::array<std::uint8_t, BOARD_SIZE>, BOARD_SIZE> rowCounts;
+        std::array<std::array<std::uint8_t, BOARD_SIZE>, BOARD_SIZE> colCounts;
+        std::array<std::array<std::uint8_t, BOARD_SIZE>, BOARD_SIZE> boxCounts;
+        std::array<CandidateMask, BOARD_SIZE> rowUsed;
+        std::array<CandidateMask, BOARD_SIZE> colUsed;
+        std::array<CandidateMask, BOARD_SIZE> boxUsed;
+
+        std::array<std::array<int, BOARD_SIZE>, BOARD_SIZE> numbers;
+        std::array<std::array<CandidateMask, BOARD_SIZE>, BOARD_SIZE> eliminated;
+        std::array<std::array<CandidateMask, BOARD_SIZE>, BOARD_SIZE> candidates;
+    };
+
+}
@@ -0,0 +1,351 @@
+#include "canonical.h"
+#include <algorithm>
+#include <bit>
+
+
+namespace Sudoku {
+
+    // Customizable parameters
+    constexpr bool PERMUTE_LINES = BOARD_SIZE <= 9;     // Permutations of the rows within bands and columns within stacks
+
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    using Grid = std::array<std::uint8_t, CELL_COUNT>;
+    using LineMask = std::uint32_t;         // Bit of every row (or column)
+
+    constexpr LineMask ALL_LINES = (LineMask(1) << BOARD_SIZE) - 1;
+    constexpr LineMask BAND_LINES = (LineMask(1) << INNER_SQUARE_SIZE) - 1;      // Lines of the first band (stack)
+
+    constexpr LineMask FIRST_LINES = []() {
+        LineMask mask = 0;
+        for (int band = 0; band < INNER_SQUARE_SIZE; band++)
+            mask |= LineMask(1) << (band * INNER_SQUARE_SIZE);
+        return mask;
+    }();
+
+    // Lines which may take the position, given the lines placed at the earlier ones (the last of them is previous)
+    // Bands are filled one after another, so at the start of a band every unused line belongs to an unused one
+    LineMask line_candidates(LineMask used, int position, int previous)
+    {
+        if (position % INNER_SQUARE_SIZE == 0)
+            return ALL_LINES & ~used & (PERMUTE_LINES ? ALL_LINES : FIRST_LINES);
+        if (!PERMUTE_LINES)
+            return LineMask(1) << (previous + 1);
+
+        return (BAND_LINES << (previous / INNER_SQUARE_SIZE * INNER_SQUARE_SIZE)) & ~used;
+    }
+
+    // Partial transformation, with the lines of the result fixed up to the current position of the search
+    struct SearchState
+    {
+        Transformation transformation;
+        LineMask usedRows = 0;
+        LineMask usedCols = 0;
+        int nextLabel = 1;
+        bool better = false;        // True if the board built so far is already smaller than the best one...
+        long bestSeen = 0;          // ...found at the time of the comparison (the newer ones share the current prefix)
+    };
+
+
+    // ---------------------
+    // CanonicalSearch class
+    // ---------------------
+
+    // Branch and bound over the transformations, building the result cell by cell in the row by row order. Only the lines
+    // giving the smallest value at the current position are followed, and interchangeable lines (identical ones of a band,
+    // or of identical bands) only once. The first row is chosen together with all the columns, the others are appended one by one.
+    class CanonicalSearch
+    {
+    public:
+        explicit CanonicalSearch(const Board& board);
+
+        Transformation run();
+
+    private:
+        // Helper functions
+        int value(const SearchState& state, int row, int col) const;
+        void assign(SearchState& state, int row, int col) const;
+        bool admit(SearchState& state, int position, int value) const;     // False if the branch cannot give a smaller board
+        bool sameLines(int first, int second, bool cols) const;     // True if the lines are interchangeable
+
+        // Search components
+        void searchColumns(SearchState& state, int position);
+        void searchRows(SearchState& state, int position);
+        void finish(const SearchState& state);
+
+        std::array<Grid, 2> sources;        // The board, and the board transposed
+        const Grid* source = nullptr;
+        Grid current = {};                  // Result built by the current branch
+        Grid best = {};
+        Transformation bestTransformation;
+        long bestCount = 0;                 // Number of improvements of the best board (none found yet if 0)
+    };
+
+    CanonicalSearch::CanonicalSearch(const Board& board)
+    {
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            sources[0][cell] = std::uint8_t(board.getNumber(cell));
+            sources[1][cell_index(CELL_COL[cell], CELL_ROW[cell])] = std::uint8_t(board.getNumber(cell));
+        }
+    }
+
+    Transformation CanonicalSearch::run()
+    {
+        for (bool transposed : { false, true }) {
+            source = &sources[transposed];
+
+            LineMask tried = 0;
+            for (LineMask candidates = line_candidates(0, 0, 0); candidates != 0; candidates &= candidates - 1) {
+                int row = std::countr_zero(candidates);
+                bool repeated = false;
+                for (LineMask rest = tried; rest != 0 && !repeated; rest &= rest - 1)
+                    repeated = sameLines(std::countr_zero(rest), row, false);
+                if (repeated)
+                    continue;
+                tried |= LineMask(1) << row;
+
+                SearchState state;
+                state.transformation.transposed = transposed;
+                state.transformation.rows[0] = std::uint8_t(row);
+                state.usedRows = LineMask(1) << row;
+                searchColumns(state, 0);
+            }
+        }
+
+        // Numbers missing from the board get the remaining labels, in the ascending order
+        std::array<std::uint8_t, BOARD_SIZE + 1>& labels = bestTransformation.labels;
+        int nextLabel = 1 + int(std::count_if(labels.begin() + 1, labels.end(), [](std::uint8_t label) { return label != 0; }));
+        for (int num = 1; num <= BOARD_SIZE; num++) {
+            if (labels[num] == 0)
+                labels[num] = std::uint8_t(nextLabel++);
+        }
+
+        return bestTransformation;
+    }
+
+    int CanonicalSearch::value(const SearchState& state, int row, int col) const
+    {
+        int num = (*source)[cell_index(row, col)];
+        if (num == 0)
+            return 0;
+
+        int label = state.transformation.labels[num];
+        return label != 0 ? label : state.nextLabel;
+    }
+
+    void CanonicalSearch::assign(SearchState& state, int row, int col) const
+    {
+        int num = (*source)[cell_index(row, col)];
+        if (num != 0 && state.transformation.labels[num] == 0)
+            state.transformation.labels[num] = std::uint8_t(state.nextLabel++);
+    }
+
+    bool CanonicalSearch::admit(SearchState& state, int position, int value) const
+    {
+        bool better = bestCount == 0 || (state.better && state.bestSeen == bestCount);
+        if (!better) {
+            if (value > best[position])
+                return false;
+            better = value < best[position];
+        }
+
+        state.better = better;
+        state.bestSeen = bestCount;
+        return true;
+    }
+
+    bool CanonicalSearch::sameLines(int first, int second, bool cols) const
+    {
+        auto field = [this, cols](int line, int index) { return (*source)[cols ? cell_index(index, line) : cell_index(line, index)]; };
+        auto sameLine = [&field](int first, int second) {
+            for (int index = 0; index < BOARD_SIZE; index++) {
+                if (field(first, index) != field(second, index))
+                    return false;
+            }
+            return true;
+        };
+
+        // Lines of a band, or lines at the same place of identical bands (which can be swapped as well)
+        int firstBand = first / INNER_SQUARE_SIZE, secondBand = second / INNER_SQUARE_SIZE;
+        if (firstBand == secondBand)
+            return sameLine(first, second);
+        if (first % INNER_SQUARE_SIZE != second % INNER_SQUARE_SIZE)
+            return false;
+
+        for (int line = 0; line < INNER_SQUARE_SIZE; line++) {
+            if (!sameLine(firstBand * INNER_SQUARE_SIZE + line, secondBand * INNER_SQUARE_SIZE + line))
+                return false;
+        }
+        return true;
+    }
+
+    void CanonicalSearch::searchColumns(SearchState& state, int position)
+    {
+        int row = state.transformation.rows[0];
+        int previous = position > 0 ? state.transformation.cols[position - 1] : 0;
+        LineMask candidates = line_candidates(state.usedCols, position, previous);
+
+        int minValue = BOARD_SIZE + 1;
+        for (LineMask rest = candidates; rest != 0; rest &= rest - 1)
+            minValue = std::min(minValue, value(state, row, std::countr_zero(rest)));
+
+        LineMask tried = 0;
+        for (; candidates != 0; candidates &= candidates - 1) {
+            int col = std::countr_zero(candidates);
+            if (value(state, row, col) != minValue)
+                continue;
+
+            bool repeated = false;
+            for (LineMask rest = tried; rest != 0 && !repeated; rest &= rest - 1)
+                repeated = sameLines(std::countr_zero(rest), col, true);
+            if (repeated)
+                continue;
+            tried |= LineMask(1) << col;
+
+            // Every candidate gives the same value, so none of them can if the first one cannot
+            SearchState next = state;
+            if (!admit(next, position, minValue))
+                return;
+
+            next.transformation.cols[position] = std::uint8_t(col);
+            next.usedCols |= LineMask(1) << col;
+            assign(next, row, col);
+            current[position] = std::uint8_t(minValue);
+
+            if (position + 1 < BOARD_SIZE)
+                searchColumns(next, position + 1);
+            else
+                searchRows(next, 1);
+        }
+    }
+
+    void CanonicalSearch::searchRows(SearchState& state, int position)
+    {
+        if (position == BOARD_SIZE) {
+            finish(state);
+            return;
+        }
+
+        const std::array<std::uint8_t, BOARD_SIZE>& cols = state.transformation.cols;
+        LineMask candidates = line_candidates(state.usedRows, position, state.transformation.rows[position - 1]);
+
+        // Smallest of the candidate rows, numbered as if they were appended
+        std::array<std::uint8_t, BOARD_SIZE> minRow, candidateRow;
+        LineMask minRows = 0;
+        for (LineMask rest = candidates; rest != 0; rest &= rest - 1) {
+            int row = std::countr_zero(rest);
+            SearchState trial = state;
+            for (int col = 0; col < BOARD_SIZE; col++) {
+                candidateRow[col] = std::uint8_t(value(trial, row, cols[col]));
+                assign(trial, row, cols[col]);
+            }
+
+            if (minRows == 0 || candidateRow < minRow) {
+                minRow = candidateRow;
+                minRows = 0;
+            }
+            if (candidateRow == minRow)
+                minRows |= LineMask(1) << row;
+        }
+
+        LineMask tried = 0;
+        for (; minRows != 0; minRows &= minRows - 1) {
+            int row = std::countr_zero(minRows);
+            bool repeated = false;
+            for (LineMask rest = tried; rest != 0 && !repeated; rest &= rest - 1)
+                repeated = sameLines(std::countr_zero(rest), row, false);
+            if (repeated)
+                continue;
+            tried |= LineMask(1) << row;
+
+            SearchState next = state;
+            for (int col = 0; col < BOARD_SIZE; col++) {
+                if (!admit(next, cell_index(position, col), minRow[col]))
+                    return;
+                current[cell_index(position, col)] = minRow[col];
+                assign(next, row, cols[col]);
+            }
+
+            next.transformation.rows[position] = std::uint8_t(row);
+            next.usedRows |= LineMask(1) << row;
+            searchRows(next, position + 1);
+        }
+    }
+
+    void CanonicalSearch::finish(const SearchState& state)
+    {
+        if (bestCount != 0 && !(state.better && state.bestSeen == bestCount))
+            return;
+
+        best = current;
+        bestTransformation = state.transformation;
+        bestCount++;
+    }
+
+
+    // ----------------------
+    // Transformation methods
+    // ----------------------
+
+    Board Transformation::apply(const Board& board) const
+    {
+        Board result;
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++) {
+                int num = transposed ? board.getNumber(cols[c], rows[r]) : board.getNumber(rows[r], cols[c]);
+                result.setNumber(r, c, labels[num]);
+            }
+        }
+
+        return result;
+    }
+
+    Board Transformation::revert(const Board& board) const
+    {
+        std::array<std::uint8_t, BOARD_SIZE + 1> numbers = {};
+        for (int num = 0; num <= BOARD_SIZE; num++)
+            numbers[labels[num]] = std::uint8_t(num);
+
+        Board result;
+        for (int r = 0; r < BOARD_SIZE; r++) {
+            for (int c = 0; c < BOARD_SIZE; c++) {
+                if (transposed)
+                    result.setNumber(cols[c], rows[r], numbers[board.getNumber(r, c)]);
+                else
+                    result.setNumber(rows[r], cols[c], numbers[board.getNumber(r, c)]);
+            }
+        }
+
+        return result;
+    }
+
+
+    // --------------
+    // Canonical form
+    // --------------
+
+    CanonicalForm canonical_form(const Board& board)
+    {
+        CanonicalForm form;
+        form.transformation = CanonicalSearch(board).run();
+        form.board = form.transformation.apply(board);
+
+        return form;
+    }
+
+    std::uint64_t board_hash(const Board& board)
+    {
+        // FNV-1a over the fields, with a final mix of the bits (the low ones index the hash tables)
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            hash = (hash ^ std::uint64_t(board.getNumber(cell))) * 0x100000001B3ull;
+
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        return hash ^ (hash >> 31);
+    }
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "board.h"
+#include <array>
+#include <cstdint>
+
+
+namespace Sudoku {
+
+    // ---------------------
+    // Transformation struct
+    // ---------------------
+
+    // Change of a board which keeps it valid (and its solutions the solutions of the result): an optional transposition,
+    // then permutations of the rows and columns which keep the bands and stacks together, and a relabeling of the numbers
+    struct Transformation
+    {
+        bool transposed = false;
+        std::array<std::uint8_t, BOARD_SIZE> rows = {};         // Source row of every row of the result (after the transposition)
+        std::array<std::uint8_t, BOARD_SIZE> cols = {};
+        std::array<std::uint8_t, BOARD_SIZE + 1> labels = {};   // New number of every number (a permutation), 0 stays 0
+
+        Board apply(const Board& board) const;
+        Board revert(const Board& board) const;                 // Inverse of apply()
+    };
+
+
+    // --------------
+    // Canonical form
+    // --------------
+
+    // Representative of all the boards equivalent to the given one - the smallest of them in the row by row order,
+    // with the empty fields first. Equivalent boards (e.g. the same puzzle rotated and with swapped numbers) share it.
+    // 9x9 boards are reduced by the whole symmetry group, bigger ones by the transposition, relabeling and permutations
+    // of the bands and stacks only - permuting the lines within them explodes on the sparse rows of their puzzles.
+    struct CanonicalForm
+    {
+        Board board;
+        Transformation transformation;      // Turns the original board into the canonical one
+    };
+
+    CanonicalForm canonical_form(const Board& board);
+
+    std::uint64_t board_hash(const Board& board);       // Use with canonical boards, to key all the equivalent ones the same way
+
+}
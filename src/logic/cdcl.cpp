@@ -0,0 +1,470 @@
+#include "cdcl.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace Sudoku {
+
+    // -----------------------
+    // Customizable parameters
+    // -----------------------
+
+    constexpr double VARIABLE_DECAY = 0.95;
+    constexpr float CLAUSE_DECAY = 0.999f;
+    constexpr long RESTART_UNIT = 100;              // Conflicts in the first restart interval (scaled by the Luby sequence)
+    constexpr double LEARNED_LIMIT_RATIO = 1.0 / 3;  // Initial limit of learned clauses, relative to the original ones
+    constexpr double LEARNED_LIMIT_GROWTH = 1.1;
+    constexpr long MIN_LEARNED_LIMIT = 1000;
+
+
+    // ------------------------------
+    // CdclEngine methods - interface
+    // ------------------------------
+
+    void CdclEngine::reset(int variableCount)
+    {
+        clauses.clear();
+        pool.clear();
+        watches.resize(2 * variableCount);
+        for (auto& list : watches)
+            list.clear();
+        learnedCount = 0;
+        maxLearned = 0;
+        clauseIncrement = 1.0f;
+
+        values.assign(2 * variableCount, 0);
+        levels.assign(variableCount, 0);
+        reasons.assign(variableCount, NO_CLAUSE);
+        trail.clear();
+        trailLimits.clear();
+        propagationHead = 0;
+        model.assign(variableCount, false);
+        unsatisfiable = false;
+
+        activity.assign(variableCount, 0.0);
+        phases.assign(variableCount, false);
+        heap.clear();
+        heapPositions.assign(variableCount, -1);
+        for (int var = 0; var < variableCount; var++)
+            heapInsert(var);
+        variableIncrement = 1.0;
+
+        seen.assign(variableCount, 0);
+        stats = {};
+    }
+
+    bool CdclEngine::addClause(std::span<const Literal> literals)
+    {
+        if (unsatisfiable)
+            return false;
+
+        // Satisfied clauses are skipped and false literals dropped (everything is assigned at level 0 here)
+        learned.clear();
+        for (Literal lit : literals) {
+            if (values[lit] > 0)
+                return true;
+            if (values[lit] == 0)
+                learned.push_back(lit);
+        }
+
+        stats.clauses++;
+        if (learned.empty())
+            unsatisfiable = true;
+        else if (learned.size() == 1)
+            assign(learned[0], NO_CLAUSE);
+        else
+            storeClause(learned, false);
+
+        return !unsatisfiable;
+    }
+
+    SatResult CdclEngine::solve(long conflictLimit)
+    {
+        if (unsatisfiable)
+            return SatResult::UNSATISFIABLE;
+
+        maxLearned = std::max<long>(maxLearned, std::max<long>(MIN_LEARNED_LIMIT, static_cast<long>(clauses.size() * LEARNED_LIMIT_RATIO)));
+        long restartIndex = 0;
+        long restartConflicts = RESTART_UNIT * luby(restartIndex);
+        long conflictsLeft = conflictLimit;
+
+        while (true) {
+            int conflict = propagate();
+
+            if (conflict != NO_CLAUSE) {
+                stats.conflicts++;
+                restartConflicts--;
+                if (decisionLevel() == 0) {
+                    unsatisfiable = true;
+                    return SatResult::UNSATISFIABLE;
+                }
+
+                int backtrackLevel;
+                analyze(conflict, backtrackLevel);
+                backtrack(backtrackLevel);
+                if (learned.size() == 1)
+                    assign(learned[0], NO_CLAUSE);
+                else
+                    assign(learned[0], storeClause(learned, true));
+                stats.learnedClauses++;
+
+                variableIncrement /= VARIABLE_DECAY;
+                clauseIncrement /= CLAUSE_DECAY;
+
+                if (conflictLimit != 0 && --conflictsLeft == 0) {
+                    backtrack(0);
+                    return SatResult::UNKNOWN;
+                }
+                continue;
+            }
+
+            if (restartConflicts <= 0) {
+                backtrack(0);
+                stats.restarts++;
+                restartConflicts = RESTART_UNIT * luby(++restartIndex);
+                if (learnedCount >= maxLearned)
+                    reduceLearned();
+                continue;
+            }
+
+            Literal decision = pickBranchLiteral();
+            if (decision < 0) {
+                for (int var = 0; var < variableCount(); var++)
+                    model[var] = values[positive_literal(var)] > 0;
+                backtrack(0);
+                return SatResult::SATISFIABLE;
+            }
+
+            stats.decisions++;
+            trailLimits.push_back(static_cast<int>(trail.size()));
+            assign(decision, NO_CLAUSE);
+        }
+    }
+
+
+    // ---------------------------
+    // CdclEngine methods - search
+    // ---------------------------
+
+    int CdclEngine::propagate()
+    {
+        while (propagationHead < trail.size()) {
+            Literal falseLit = negate(trail[propagationHead++]);
+            std::vector<Watcher>& list = watches[falseLit];
+            stats.propagations++;
+
+            std::size_t i = 0, j = 0;
+            while (i < list.size()) {
+                Watcher watcher = list[i++];
+                if (values[watcher.blocker] > 0) {
+                    list[j++] = watcher;
+                    continue;
+                }
+
+                // The false literal is kept second, so that the first one is the implied literal
+                Literal* lits = &pool[clauses[watcher.clause].start];
+                if (lits[0] == falseLit)
+                    std::swap(lits[0], lits[1]);
+                Literal first = lits[0];
+                if (first != watcher.blocker && values[first] > 0) {
+                    list[j++] = { watcher.clause, first };
+                    continue;
+                }
+
+                // Looking for a new literal to watch
+                int size = clauses[watcher.clause].size;
+                bool moved = false;
+                for (int k = 2; k < size; k++) {
+                    if (values[lits[k]] >= 0) {
+                        std::swap(lits[1], lits[k]);
+                        watches[lits[1]].push_back({ watcher.clause, first });
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved)
+                    continue;
+
+                // The clause is unit or conflicting
+                list[j++] = watcher;
+                if (values[first] < 0) {
+                    while (i < list.size())
+                        list[j++] = list[i++];
+                    list.resize(j);
+                    propagationHead = trail.size();
+                    return watcher.clause;
+                }
+                assign(first, watcher.clause);
+            }
+            list.resize(j);
+        }
+
+        return NO_CLAUSE;
+    }
+
+    void CdclEngine::analyze(int conflict, int& backtrackLevel)
+    {
+        learned.clear();
+        learned.push_back(0);       // Place for the asserting literal
+
+        int pathCount = 0;
+        Literal implied = -1;
+        int index = static_cast<int>(trail.size()) - 1;
+        int clause = conflict;
+
+        // Resolving the literals of the current level until a single one (the first UIP) is left
+        do {
+            bumpClause(clause);
+            const Clause& reason = clauses[clause];
+            for (int k = implied < 0 ? 0 : 1; k < reason.size; k++) {
+                Literal lit = pool[reason.start + k];
+                int var = literal_variable(lit);
+                if (seen[var] || levels[var] == 0)
+                    continue;
+
+                seen[var] = 1;
+                bumpVariable(var);
+                if (levels[var] >= decisionLevel())
+                    pathCount++;
+                else
+                    learned.push_back(lit);
+            }
+
+            while (!seen[literal_variable(trail[index--])]);
+            implied = trail[index + 1];
+            clause = reasons[literal_variable(implied)];
+            seen[literal_variable(implied)] = 0;
+            pathCount--;
+        } while (pathCount > 0);
+        learned[0] = negate(implied);
+
+        // Literals implied by the other ones are removed
+        analyzed.assign(learned.begin(), learned.end());
+        learned.erase(std::remove_if(learned.begin() + 1, learned.end(),
+                                     [this](Literal lit) { return isRedundant(lit); }), learned.end());
+        for (Literal lit : analyzed)
+            seen[literal_variable(lit)] = 0;
+
+        // The literal of the highest remaining level is watched next to the asserting one
+        backtrackLevel = 0;
+        for (std::size_t k = 1; k < learned.size(); k++) {
+            if (levels[literal_variable(learned[k])] > backtrackLevel) {
+                backtrackLevel = levels[literal_variable(learned[k])];
+                std::swap(learned[1], learned[k]);
+            }
+        }
+    }
+
+    bool CdclEngine::isRedundant(Literal lit) const
+    {
+        int reason = reasons[literal_variable(lit)];
+        if (reason == NO_CLAUSE)
+            return false;
+
+        const Clause& clause = clauses[reason];
+        for (int k = 1; k < clause.size; k++) {
+            int var = literal_variable(pool[clause.start + k]);
+            if (!seen[var] && levels[var] > 0)
+                return false;
+        }
+        return true;
+    }
+
+    void CdclEngine::backtrack(int level)
+    {
+        if (decisionLevel() <= level)
+            return;
+
+        for (int i = static_cast<int>(trail.size()) - 1; i >= trailLimits[level]; i--) {
+            int var = literal_variable(trail[i]);
+            values[positive_literal(var)] = values[negative_literal(var)] = 0;
+            reasons[var] = NO_CLAUSE;
+            phases[var] = (trail[i] & 1) == 0;
+            heapInsert(var);
+        }
+
+        trail.resize(trailLimits[level]);
+        trailLimits.resize(level);
+        propagationHead = trail.size();
+    }
+
+    void CdclEngine::assign(Literal lit, int reason)
+    {
+        int var = literal_variable(lit);
+        values[lit] = 1;
+        values[negate(lit)] = -1;
+        levels[var] = decisionLevel();
+        reasons[var] = reason;
+        trail.push_back(lit);
+    }
+
+    Literal CdclEngine::pickBranchLiteral()
+    {
+        while (!heap.empty()) {
+            int var = heapPop();
+            if (values[positive_literal(var)] == 0)
+                return phases[var] ? positive_literal(var) : negative_literal(var);
+        }
+        return -1;
+    }
+
+
+    // ------------------------------------
+    // CdclEngine methods - clause database
+    // ------------------------------------
+
+    int CdclEngine::storeClause(std::span<const Literal> literals, bool isLearned)
+    {
+        int index = static_cast<int>(clauses.size());
+        clauses.push_back({ static_cast<int>(pool.size()), static_cast<int>(literals.size()), isLearned, 0.0f });
+        pool.insert(pool.end(), literals.begin(), literals.end());
+
+        watches[literals[0]].push_back({ index, literals[1] });
+        watches[literals[1]].push_back({ index, literals[0] });
+        learnedCount += isLearned;
+
+        return index;
+    }
+
+    void CdclEngine::reduceLearned()
+    {
+        // Half of the learned clauses with the lowest activity are removed, except for the binary ones
+        std::vector<float> activities;
+        for (const Clause& clause : clauses) {
+            if (clause.learned && clause.size > 2)
+                activities.push_back(clause.activity);
+        }
+        float threshold = 0.0f;
+        if (!activities.empty()) {
+            std::nth_element(activities.begin(), activities.begin() + activities.size() / 2, activities.end());
+            threshold = activities[activities.size() / 2];
+        }
+
+        // The remaining clauses are compacted, which requires rebuilding the watches (reasons are not needed at level 0)
+        std::size_t kept = 0, poolSize = 0;
+        for (const Clause& clause : clauses) {
+            if (clause.learned && clause.size > 2 && clause.activity < threshold) {
+                learnedCount--;
+                continue;
+            }
+            std::copy(pool.begin() + clause.start, pool.begin() + clause.start + clause.size, pool.begin() + poolSize);
+            clauses[kept++] = { static_cast<int>(poolSize), clause.size, clause.learned, clause.activity };
+            poolSize += clause.size;
+        }
+        clauses.resize(kept);
+        pool.resize(poolSize);
+
+        for (auto& list : watches)
+            list.clear();
+        for (int index = 0; index < static_cast<int>(clauses.size()); index++) {
+            const Literal* lits = &pool[clauses[index].start];
+            watches[lits[0]].push_back({ index, lits[1] });
+            watches[lits[1]].push_back({ index, lits[0] });
+        }
+        std::fill(reasons.begin(), reasons.end(), NO_CLAUSE);
+
+        maxLearned = static_cast<long>(maxLearned * LEARNED_LIMIT_GROWTH);
+    }
+
+    void CdclEngine::bumpClause(int clause)
+    {
+        if (!clauses[clause].learned)
+            return;
+
+        if ((clauses[clause].activity += clauseIncrement) > 1e20f) {
+            for (Clause& other : clauses)
+                other.activity *= 1e-20f;
+            clauseIncrement *= 1e-20f;
+        }
+    }
+
+
+    // -----------------------------------
+    // CdclEngine methods - variable order
+    // -----------------------------------
+
+    void CdclEngine::bumpVariable(int var)
+    {
+        if ((activity[var] += variableIncrement) > 1e100) {
+            for (double& value : activity)
+                value *= 1e-100;
+            variableIncrement *= 1e-100;
+        }
+
+        if (heapPositions[var] >= 0)
+            heapUp(heapPositions[var]);
+    }
+
+    void CdclEngine::heapInsert(int var)
+    {
+        if (heapPositions[var] >= 0)
+            return;
+
+        heapPositions[var] = static_cast<int>(heap.size());
+        heap.push_back(var);
+        heapUp(heapPositions[var]);
+    }
+
+    int CdclEngine::heapPop()
+    {
+        int top = heap.front();
+        heap.front() = heap.back();
+        heapPositions[heap.front()] = 0;
+        heap.pop_back();
+        heapPositions[top] = -1;
+        if (!heap.empty())
+            heapDown(0);
+
+        return top;
+    }
+
+    void CdclEngine::heapUp(int pos)
+    {
+        int var = heap[pos];
+        while (pos > 0) {
+            int parent = (pos - 1) / 2;
+            if (activity[heap[parent]] >= activity[var])
+                break;
+            heap[pos] = heap[parent];
+            heapPositions[heap[pos]] = pos;
+            pos = parent;
+        }
+        heap[pos] = var;
+        heapPositions[var] = pos;
+    }
+
+    void CdclEngine::heapDown(int pos)
+    {
+        int var = heap[pos];
+        int size = static_cast<int>(heap.size());
+        while (2 * pos + 1 < size) {
+            int child = 2 * pos + 1;
+            if (child + 1 < size && activity[heap[child + 1]] > activity[heap[child]])
+                child++;
+            if (activity[heap[child]] <= activity[var])
+                break;
+            heap[pos] = heap[child];
+            heapPositions[heap[pos]] = pos;
+            pos = child;
+        }
+        heap[pos] = var;
+        heapPositions[var] = pos;
+    }
+
+    long CdclEngine::luby(long index)
+    {
+        // Finding the complete subsequence containing the index: 1 1 2 1 1 2 4 ...
+        long size = 1, sequence = 0;
+        while (size < index + 1) {
+            sequence++;
+            size = 2 * size + 1;
+        }
+        while (size - 1 != index) {
+            size = (size - 1) / 2;
+            sequence--;
+            index %= size;
+        }
+        return 1L << sequence;
+    }
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    // Literal of a boolean variable: 2 * var for the variable itself and 2 * var + 1 for its negation
+    using Literal = int;
+
+    constexpr Literal positive_literal(int var) { return 2 * var; }
+    constexpr Literal negative_literal(int var) { return 2 * var + 1; }
+    constexpr Literal negate(Literal lit) { return lit ^ 1; }
+    constexpr int literal_variable(Literal lit) { return lit >> 1; }
+
+    enum class SatResult : int {
+        SATISFIABLE,
+        UNSATISFIABLE,
+        UNKNOWN             // Conflict limit reached
+    };
+
+
+    // ----------------
+    // CdclEngine class
+    // ----------------
+
+    // Conflict-driven clause learning SAT solver: two watched literals, first-UIP learning with clause minimization,
+    // VSIDS branching with phase saving, Luby restarts and periodic reduction of the learned clauses.
+    // Clauses may only be added between the calls to solve, which makes incremental use (e.g. blocking clauses) possible.
+    class CdclEngine
+    {
+    public:
+        void reset(int variableCount);      // Removes all the clauses and keeps the allocated memory
+
+        bool addClause(std::span<const Literal> literals);     // Literals must be distinct; returns false if the formula became unsatisfiable
+        SatResult solve(long conflictLimit = 0);                // 0 stands for no limit
+        bool modelValue(int var) const { return model[var]; }   // Assignment found by the last succesful solve
+
+        int variableCount() const { return static_cast<int>(activity.size()); }
+
+        // Statistics accumulated since the last reset
+        struct Stats
+        {
+            long clauses = 0;
+            long decisions = 0;
+            long propagations = 0;
+            long conflicts = 0;
+            long learnedClauses = 0;
+            long restarts = 0;
+        };
+
+        const Stats& getStats() const { return stats; }
+
+    private:
+        static constexpr int NO_CLAUSE = -1;
+
+        struct Clause
+        {
+            int start;              // Position of the literals in the pool
+            int size;
+            bool learned;
+            float activity;
+        };
+
+        // Clause watched by a literal, with another literal of the clause which makes the visit unnecessary when true
+        struct Watcher
+        {
+            int clause;
+            Literal blocker;
+        };
+
+        // Helper functions - search
+        int propagate();                        // Returns the conflicting clause or NO_CLAUSE
+        void analyze(int conflict, int& backtrackLevel);    // Fills learned with the learned clause, asserting literal first
+        bool isRedundant(Literal lit) const;
+        void backtrack(int level);
+        void assign(Literal lit, int reason);
+        Literal pickBranchLiteral();
+        int decisionLevel() const { return static_cast<int>(trailLimits.size()); }
+        // Helper functions - clause database
+        int storeClause(std::span<const Literal> literals, bool isLearned);
+        void reduceLearned();                   // Only at decision level 0
+        void bumpClause(int clause);
+        // Helper functions - variable order
+        void bumpVariable(int var);
+        void heapInsert(int var);
+        int heapPop();
+        void heapUp(int pos);
+        void heapDown(int pos);
+        static long luby(long index);
+
+        // Clauses
+        std::vector<Clause> clauses;
+        std::vector<Literal> pool;
+        std::vector<std::vector<Watcher>> watches;      // Indexed by literal, visited when the literal becomes false
+        long learnedCount = 0;
+        long maxLearned = 0;
+        float clauseIncrement = 1.0f;
+
+        // Assignment
+        std::vector<std::int8_t> values;        // Indexed by literal: 1 true, -1 false, 0 unassigned
+        std::vector<int> levels;
+        std::vector<int> reasons;
+        std::vector<Literal> trail;
+        std::vector<int> trailLimits;           // Trail size at the beginning of every decision level
+        std::size_t propagationHead = 0;
+        std::vector<bool> model;
+        bool unsatisfiable = false;
+
+        // Branching
+        std::vector<double> activity;
+        std::vector<bool> phases;               // Last assigned value of every variable
+        std::vector<int> heap;                  // Unassigned variables (and possibly some assigned ones) by activity
+        std::vector<int> heapPositions;         // -1 for variables outside of the heap
+        double variableIncrement = 1.0;
+
+        // Conflict analysis
+        std::vector<Literal> learned;
+        std::vector<Literal> analyzed;
+        std::vector<std::uint8_t> seen;
+
+        Stats stats;
+    };
+
+}
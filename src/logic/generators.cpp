@@ -1,53 +1,115 @@
 #include "generators.h"
+#include "traceSpans.h"
 #include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <vector>
 
 
 namespace Sudoku {
 
+    // Customizable parameters
+    constexpr int MIN_REMOVED_PERCENT = 14;         // Part of the fields emptied in a generated position (11 - 61 fields on a 9x9 board)
+    constexpr int MAX_REMOVED_PERCENT = 76;
+    constexpr std::size_t POSITIONS_PER_TASK = 16;
+
     // -------------------------
     // PosiitonGenerator methods
     // -------------------------
 
-    PositionGenerator::PositionGenerator(Solver* solver)
-        : solver(solver), randomGen(randomDev())
+    PositionGenerator::PositionGenerator(Solver* solver, std::uint64_t seed)
+        : solver(solver), random(seed)
     {
     }
 
-    void PositionGenerator::generate(Board& board)
+    void PositionGenerator::generate(Board& board, RandomStream& stream)
     {
-        board.clear();
-
-        // Fill in all the inner squares on the diagonal with random (but correct) numbers
-        for (int is = 0; is < BOARD_SIZE; is += INNER_SQUARE_SIZE + 1) {
-            // Create a random permutation of all possible numbers
-            std::vector<int> nums = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-            std::shuffle(nums.begin(), nums.end(), randomGen);
-
-            // Fill in the fields with the obtained permutation from top to bottom
-            auto [r0, c0] = Board::innerSquareTopLeft(is);
-            for (int i = 0; i < INNER_SQUARE_SIZE; i++) {
-                for (int j = 0; j < INNER_SQUARE_SIZE; j++)
-                    board.setNumber(r0 + i, c0 + j, nums[i * INNER_SQUARE_SIZE + j]);
+        TraceSpan span("generate", "generator");
+
+        // A board with filled diagonal squares always has a solution, but the solver might give up on it
+        // (e.g. due to its backtrack limit) - then the whole position is drawn again
+        bool completed = false;
+        while (!completed) {
+            board.clear();
+
+            // Fill in all the inner squares on the diagonal with random (but correct) numbers
+            TraceSpan diagonalSpan("fill diagonal", "generator");
+            for (int is = 0; is < BOARD_SIZE; is += INNER_SQUARE_SIZE + 1) {
+                // Create a random permutation of all possible numbers
+                std::array<int, BOARD_SIZE> nums;
+                std::iota(nums.begin(), nums.end(), 1);
+                stream.shuffle(nums.begin(), nums.end());
+
+                // Fill in the fields with the obtained permutation from top to bottom
+                for (int i = 0; i < BOARD_SIZE; i++)
+                    board.setNumber(box_cells(is)[i], nums[i]);
             }
-        }
+            diagonalSpan.end();
 
-        // Complete the board
-        // Since solve() method is deterministic, this gives 9! * 9! * 9! different board configurations
-        solver->solve(board);
+            // Complete the board - with the SAT backend on the bigger boards, as the search occasionally explodes on them
+            // Since both solvers are deterministic, this gives (n!)^sqrt(n) different board configurations (9! * 9! * 9! for a 9x9 board)
+            TraceSpan completionSpan("complete board", "generator");
+            if constexpr (BOARD_SIZE > 9)
+                completed = satSolver.solve(board);
+            else
+                completed = solver->solve(board);
+        }
 
         // Remove some numbers
-        std::vector<int> fields(BOARD_SIZE * BOARD_SIZE, 0);
+        TraceSpan removalSpan("remove fields", "generator");
+        std::array<int, CELL_COUNT> fields;
         std::iota(fields.begin(), fields.end(), 0);
-        std::shuffle(fields.begin(), fields.end(), randomGen);
-
-        std::uniform_int_distribution<> distribution(11, 61);
-        int r = distribution(randomGen);
+        stream.shuffle(fields.begin(), fields.end());
 
         // Remove random number of elements from board
+        int r = stream.between(CELL_COUNT * MIN_REMOVED_PERCENT / 100, CELL_COUNT * MAX_REMOVED_PERCENT / 100);
         for (int i = 0; i < r; i++)
-            board.setNumber(fields[i] / BOARD_SIZE, fields[i] % BOARD_SIZE, 0);
+            board.setNumber(fields[i], 0);
+    }
+
+
+    // --------------------
+    // Parallel generation
+    // --------------------
+
+    void generate_positions(std::span<Board> boards, std::uint64_t seed, ThreadPool& pool, std::uint64_t firstIndex)
+    {
+        // Every worker completes the boards with its own solver
+        struct WorkerGenerator
+        {
+            Solver solver;
+            PositionGenerator generator;
+
+            WorkerGenerator() : generator(&solver, 0) {}
+        };
+
+        std::vector<std::unique_ptr<WorkerGenerator>> generators;
+        for (unsigned i = 0; i < pool.size(); i++)
+            generators.push_back(std::make_unique<WorkerGenerator>());
+
+        RandomStream root(seed);
+        std::size_t tasks = (boards.size() + POSITIONS_PER_TASK - 1) / POSITIONS_PER_TASK;
+        std::size_t remainingTasks = tasks;
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        for (std::size_t task = 0; task < tasks; task++) {
+            pool.submit([&, task](unsigned worker) {
+                for (std::size_t i = task * POSITIONS_PER_TASK; i < std::min(boards.size(), (task + 1) * POSITIONS_PER_TASK); i++) {
+                    RandomStream stream = root.fork(firstIndex + i);
+                    generators[worker]->generator.generate(boards[i], stream);
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--remainingTasks == 0)
+                    finished.notify_all();
+            });
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&remainingTasks]() { return remainingTasks == 0; });
     }
 
-}
\ No newline at end of file
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "random.h"
+#include "satSolver.h"
 #include "solver.h"
-#include <random>
+#include "threadPool.h"
+#include <span>
 
 
 namespace Sudoku {
@@ -10,21 +13,28 @@ namespace Sudoku {
     // PosiitonGenerator class
     // -----------------------
 
-    // Generates a random, solvable sudoku position
+    // Generates a random, solvable sudoku position. The generated position depends only on the random stream,
+    // so a seeded generator gives the same sequence of positions on every run and platform.
+    // The solver should have no random branching heuristic, as its choices would affect the position as well.
     class PositionGenerator
     {
     public:
-        PositionGenerator(Solver* solver);
+        explicit PositionGenerator(Solver* solver, std::uint64_t seed = random_seed());
+
+        // Main generation methods
+        void generate(Board& board) { generate(board, random); }    // Next position of the generator's own stream
+        void generate(Board& board, RandomStream& stream);
+
+        void seed(std::uint64_t seed) { random = RandomStream(seed); }
 
-        // Main generation method
-        void generate(Board& board);
-    
     private:
         Solver* solver;
-
-        // Random number generation
-        std::random_device randomDev;
-        std::mt19937 randomGen;
+        SatSolver satSolver;        // Completes the boards bigger than 9x9
+        RandomStream random;
     };
 
-}
\ No newline at end of file
+    // Generates the positions on the workers of the pool. Position i is generated from the stream fork(firstIndex + i)
+    // of the seed, so the result does not depend on the number of workers or on the scheduling.
+    void generate_positions(std::span<Board> boards, std::uint64_t seed, ThreadPool& pool, std::uint64_t firstIndex = 0);
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// Size of the inner squares, chosen at build time: 3 for classic 9x9 boards, 4 for 16x16 and 5 for 25x25 ones
+#ifndef SUDOKU_BOX_SIZE
+#define SUDOKU_BOX_SIZE 3
+#endif
+
+
+namespace Sudoku {
+
+    // --------------
+    // Board geometry
+    // --------------
+
+    constexpr int INNER_SQUARE_SIZE = SUDOKU_BOX_SIZE;
+    constexpr int BOARD_SIZE = INNER_SQUARE_SIZE * INNER_SQUARE_SIZE;
+
+    static_assert(INNER_SQUARE_SIZE >= 3 && INNER_SQUARE_SIZE <= 5, "Supported boards are 9x9, 16x16 and 25x25");
+
+    constexpr int CELL_COUNT = BOARD_SIZE * BOARD_SIZE;
+    constexpr int UNIT_COUNT = 3 * BOARD_SIZE;                                                  // Rows, columns and inner squares
+    constexpr int PEER_COUNT = 2 * (BOARD_SIZE - 1) + (INNER_SQUARE_SIZE - 1) * (INNER_SQUARE_SIZE - 1);    // 20 for a 9x9 board
+
+    // Offsets of the unit kinds in UNIT_CELLS
+    enum UnitOffset : int { ROW_UNITS = 0, COL_UNITS = BOARD_SIZE, BOX_UNITS = 2 * BOARD_SIZE };
+
+    // Fields are indexed row by row - index of a field is row * BOARD_SIZE + col
+    constexpr int cell_index(int row, int col) { return row * BOARD_SIZE + col; }
+
+    // Narrowest type able to hold a field index
+    using CellIndex = std::conditional_t<CELL_COUNT <= 256, std::uint8_t, std::uint16_t>;
+
+    using CellList = std::array<CellIndex, BOARD_SIZE>;
+
+
+    // ---------------
+    // Geometry tables
+    // ---------------
+
+    // All the tables are generated at compile time, so that the logic modules can walk them instead of
+    // recomputing the geometry with divisions and modulos
+
+    inline constexpr std::array<std::uint8_t, CELL_COUNT> CELL_ROW = []() {
+        std::array<std::uint8_t, CELL_COUNT> rows = {};
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            rows[cell] = std::uint8_t(cell / BOARD_SIZE);
+        return rows;
+    }();
+
+    inline constexpr std::array<std::uint8_t, CELL_COUNT> CELL_COL = []() {
+        std::array<std::uint8_t, CELL_COUNT> cols = {};
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            cols[cell] = std::uint8_t(cell % BOARD_SIZE);
+        return cols;
+    }();
+
+    inline constexpr std::array<std::uint8_t, CELL_COUNT> CELL_BOX = []() {
+        std::array<std::uint8_t, CELL_COUNT> boxes = {};
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            int row = cell / BOARD_SIZE, col = cell % BOARD_SIZE;
+            boxes[cell] = std::uint8_t(row - row % INNER_SQUARE_SIZE + col / INNER_SQUARE_SIZE);
+        }
+        return boxes;
+    }();
+
+    // Cells of every row, column and inner square, in this order (see UnitOffset)
+    inline constexpr std::array<CellList, UNIT_COUNT> UNIT_CELLS = []() {
+        std::array<CellList, UNIT_COUNT> units = {};
+        std::array<int, UNIT_COUNT> sizes = {};
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            for (int unit : { ROW_UNITS + CELL_ROW[cell], COL_UNITS + CELL_COL[cell], BOX_UNITS + CELL_BOX[cell] })
+                units[unit][sizes[unit]++] = CellIndex(cell);
+        }
+        return units;
+    }();
+
+    constexpr const CellList& row_cells(int row) { return UNIT_CELLS[ROW_UNITS + row]; }
+    constexpr const CellList& col_cells(int col) { return UNIT_CELLS[COL_UNITS + col]; }
+    constexpr const CellList& box_cells(int box) { return UNIT_CELLS[BOX_UNITS + box]; }     // Row by row, from the top left cell
+
+    // Cells sharing a row, column or inner square with the given cell (not including the cell itself)
+    inline constexpr std::array<std::array<CellIndex, PEER_COUNT>, CELL_COUNT> CELL_PEERS = []() {
+        std::array<std::array<CellIndex, PEER_COUNT>, CELL_COUNT> peers = {};
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            // Walking the peers row by row keeps them in ascending order, and the evaluation cheap enough for 25x25 boards
+            int row = cell / BOARD_SIZE, col = cell % BOARD_SIZE;
+            int bandRow = row - row % INNER_SQUARE_SIZE, stackCol = col - col % INNER_SQUARE_SIZE;
+            int count = 0;
+            for (int r = 0; r < BOARD_SIZE; r++) {
+                if (r == row) {
+                    for (int c = 0; c < BOARD_SIZE; c++) {
+                        if (c != col)
+                            peers[cell][count++] = CellIndex(r * BOARD_SIZE + c);
+                    }
+                }
+                else if (r >= bandRow && r < bandRow + INNER_SQUARE_SIZE) {
+                    for (int c = stackCol; c < stackCol + INNER_SQUARE_SIZE; c++)
+                        peers[cell][count++] = CellIndex(r * BOARD_SIZE + c);
+                }
+                else
+                    peers[cell][count++] = CellIndex(r * BOARD_SIZE + col);
+            }
+        }
+        return peers;
+    }();
+
+}
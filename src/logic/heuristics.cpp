@@ -0,0 +1,252 @@
+#include "heuristics.h"
+#include "random.h"
+#include <algorithm>
+
+
+namespace Sudoku {
+
+    // Customizable parameters
+    constexpr long RESTART_BASE_LIMIT = 32;             // Backtracks allowed before the first restart
+    constexpr double RESTART_LIMIT_GROWTH = 1.5;        // Every restart allows more backtracks, so that the search is complete
+    constexpr long ADAPTIVE_LCV_THRESHOLD = 16;         // Backtracks after which the adaptive heuristic switches to LCV
+    constexpr long ADAPTIVE_RESTART_THRESHOLD = 512;    // Backtracks after which the adaptive heuristic starts restarting
+
+
+    // --------------------------
+    // BranchingHeuristic methods
+    // --------------------------
+
+    int BranchingHeuristic::orderValues(const SearchContext& context, int cell, std::array<int, BOARD_SIZE>& values)
+    {
+        int count = 0;
+        for (CandidateMask options = context.possibilities[cell]; options != 0; options &= options - 1)
+            values[count++] = lowest_candidate(options);
+
+        return count;
+    }
+
+
+    // ----------------
+    // Helper functions
+    // ----------------
+
+    namespace {
+
+        int empty_peers(const SearchContext& context, int cell)
+        {
+            return static_cast<int>(std::count_if(CELL_PEERS[cell].begin(), CELL_PEERS[cell].end(), [&context](int peer) {
+                return context.board.isEmpty(peer);
+            }));
+        }
+
+        // Returns an empty field with the least candidates, prefer(cell, best) decides about ties
+        template <typename Preference>
+        int min_remaining_field(const SearchContext& context, Preference prefer)
+        {
+            int bestCell = 0, bestKey = BOARD_SIZE + 1;
+            for (int cell = 0; cell < CELL_COUNT; cell++) {
+                int key = candidate_count(context.possibilities[cell]);
+                if (key == 0)
+                    continue;
+                if (key < bestKey || (key == bestKey && prefer(cell, bestCell))) {
+                    bestCell = cell;
+                    bestKey = key;
+                }
+            }
+
+            return bestCell;
+        }
+
+
+        // --------------
+        // MRV heuristics
+        // --------------
+
+        class MrvHeuristic : public BranchingHeuristic
+        {
+        public:
+            int selectField(const SearchContext& context) override
+            {
+                return min_remaining_field(context, [](int, int) { return false; });
+            }
+        };
+
+        class MrvDegreeHeuristic : public BranchingHeuristic
+        {
+        public:
+            int selectField(const SearchContext& context) override
+            {
+                // Fields constraining the most other fields go first
+                return min_remaining_field(context, [&context](int cell, int best) {
+                    return empty_peers(context, cell) > empty_peers(context, best);
+                });
+            }
+        };
+
+        class LcvHeuristic : public MrvDegreeHeuristic
+        {
+        public:
+            int orderValues(const SearchContext& context, int cell, std::array<int, BOARD_SIZE>& values) override
+            {
+                int count = BranchingHeuristic::orderValues(context, cell, values);
+
+                // Values removing the least candidates from the peers go first
+                std::array<int, BOARD_SIZE + 1> removals = {};
+                for (int peer : CELL_PEERS[cell]) {
+                    for (int i = 0; i < count; i++)
+                        removals[values[i]] += (context.possibilities[peer] & candidate_bit(values[i])) != 0;
+                }
+
+                // Insertion sort - stable and in place (std::stable_sort allocates a buffer, and there are at most BOARD_SIZE values)
+                for (int i = 1; i < count; i++) {
+                    int value = values[i], j = i;
+                    for (; j > 0 && removals[values[j - 1]] > removals[value]; j--)
+                        values[j] = values[j - 1];
+                    values[j] = value;
+                }
+                return count;
+            }
+        };
+
+
+        // -------------------------
+        // Random restarts heuristic
+        // -------------------------
+
+        class RandomRestartHeuristic : public BranchingHeuristic
+        {
+        public:
+            explicit RandomRestartHeuristic(unsigned seed) : randomGen(seed) {}
+
+            void start(int restart) override
+            {
+                limit = restart == 0 ? RESTART_BASE_LIMIT : static_cast<long>(limit * RESTART_LIMIT_GROWTH);
+            }
+
+            int selectField(const SearchContext& context) override
+            {
+                // Uniformly random choice among the fields with the least candidates
+                int first = min_remaining_field(context, [](int, int) { return false; });
+                int key = candidate_count(context.possibilities[first]);
+                int ties = static_cast<int>(std::count_if(context.possibilities.begin() + first, context.possibilities.end(),
+                                                          [key](CandidateMask options) { return candidate_count(options) == key; }));
+
+                int choice = randomGen.below(ties);
+                for (int cell = first; cell < CELL_COUNT; cell++) {
+                    if (candidate_count(context.possibilities[cell]) == key && choice-- == 0)
+                        return cell;
+                }
+                return first;
+            }
+
+            int orderValues(const SearchContext& context, int cell, std::array<int, BOARD_SIZE>& values) override
+            {
+                int count = BranchingHeuristic::orderValues(context, cell, values);
+                randomGen.shuffle(values.begin(), values.begin() + count);
+                return count;
+            }
+
+            long restartLimit(const SearchContext&) override { return limit; }
+
+        private:
+            RandomStream randomGen;
+            long limit = RESTART_BASE_LIMIT;
+        };
+
+
+        // ------------------
+        // Adaptive heuristic
+        // ------------------
+
+        // Cheap MRV is enough for most of the puzzles, while the other strategies pay off only for the hard ones
+        class AdaptiveHeuristic : public BranchingHeuristic
+        {
+        public:
+            explicit AdaptiveHeuristic(unsigned seed) : restarts(seed) {}
+
+            void start(int restart) override { restarts.start(restart); }
+
+            int selectField(const SearchContext& context) override { return strategy(context).selectField(context); }
+
+            int orderValues(const SearchContext& context, int cell, std::array<int, BOARD_SIZE>& values) override
+            {
+                return strategy(context).orderValues(context, cell, values);
+            }
+
+            long restartLimit(const SearchContext& context) override
+            {
+                return context.backtracks >= ADAPTIVE_RESTART_THRESHOLD ? restarts.restartLimit(context) : 0;
+            }
+
+        private:
+            BranchingHeuristic& strategy(const SearchContext& context)
+            {
+                if (context.backtracks >= ADAPTIVE_RESTART_THRESHOLD)
+                    return restarts;
+                if (context.backtracks >= ADAPTIVE_LCV_THRESHOLD)
+                    return lcv;
+                return mrv;
+            }
+
+            MrvHeuristic mrv;
+            LcvHeuristic lcv;
+            RandomRestartHeuristic restarts;
+        };
+
+    }
+
+
+    // -----------------
+    // Heuristic factory
+    // -----------------
+
+    std::unique_ptr<BranchingHeuristic> make_heuristic(HeuristicType type, unsigned seed)
+    {
+        switch (type) {
+            case HeuristicType::MRV:
+                return std::make_unique<MrvHeuristic>();
+            case HeuristicType::MRV_DEGREE:
+                return std::make_unique<MrvDegreeHeuristic>();
+            case HeuristicType::LCV:
+                return std::make_unique<LcvHeuristic>();
+            case HeuristicType::RANDOM_RESTARTS:
+                return std::make_unique<RandomRestartHeuristic>(seed);
+            case HeuristicType::ADAPTIVE:
+                return std::make_unique<AdaptiveHeuristic>(seed);
+        }
+
+        return nullptr;
+    }
+
+    const char* heuristic_name(HeuristicType type)
+    {
+        switch (type) {
+            case HeuristicType::MRV:
+                return "mrv";
+            case HeuristicType::MRV_DEGREE:
+                return "mrv-degree";
+            case HeuristicType::LCV:
+                return "lcv";
+            case HeuristicType::RANDOM_RESTARTS:
+                return "restarts";
+            case HeuristicType::ADAPTIVE:
+                return "adaptive";
+        }
+
+        return "unknown";
+    }
+
+    bool parse_heuristic(const std::string& name, HeuristicType& type)
+    {
+        for (HeuristicType candidate : { HeuristicType::MRV, HeuristicType::MRV_DEGREE, HeuristicType::LCV,
+                                         HeuristicType::RANDOM_RESTARTS, HeuristicType::ADAPTIVE }) {
+            if (name == heuristic_name(candidate)) {
+                type = candidate;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+}
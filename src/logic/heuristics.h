@@ -0,0 +1,61 @@
+#pragma once
+
+#include "candidates.h"
+#include <memory>
+#include <string>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    // State of the search at a branching point, as seen by the heuristics
+    struct SearchContext
+    {
+        const Board& board;
+        const Possibilities& possibilities;     // Empty for filled fields
+        long guesses;               // Counted since the beginning of the solve (including restarts)
+        long backtracks;
+        long restartBacktracks;     // Counted since the last restart
+    };
+
+
+    // ------------------------
+    // BranchingHeuristic class
+    // ------------------------
+
+    // Decides where and in what order the solver guesses, once no forced moves are left.
+    // Only called for fields with at least two candidates - forced moves are always made by the solver itself.
+    class BranchingHeuristic
+    {
+    public:
+        virtual ~BranchingHeuristic() = default;
+
+        virtual void start(int) {}                                      // Called before the search and before every restart (numbered from 1)
+        virtual int selectField(const SearchContext& context) = 0;     // Returns an index of an empty field to branch on
+        virtual int orderValues(const SearchContext& context, int cell,    // Fills values with candidates in the order of trying
+                                std::array<int, BOARD_SIZE>& values);      // and returns their number (ascending by default)
+        virtual long restartLimit(const SearchContext&) { return 0; }         // Backtracks after which the search restarts (0 - never)
+    };
+
+
+    // -------------------------
+    // Available heuristic types
+    // -------------------------
+
+    enum class HeuristicType : int {
+        MRV,                // Field with minimum remaining values (the solver's default)
+        MRV_DEGREE,         // As above, ties broken by the number of empty peers
+        LCV,                // MRV with degree, values ordered from the least constraining one
+        RANDOM_RESTARTS,    // MRV with random tie-breaking and value order, restarted with growing backtrack limits
+        ADAPTIVE            // Switches from MRV to LCV and then to random restarts as the backtracks accumulate
+    };
+
+    std::unique_ptr<BranchingHeuristic> make_heuristic(HeuristicType type, unsigned seed = 0);
+
+    const char* heuristic_name(HeuristicType type);
+    bool parse_heuristic(const std::string& name, HeuristicType& type);    // Returns false for unknown names
+
+}
@@ -0,0 +1,111 @@
+#include "journal.h"
+#include <algorithm>
+
+
+namespace Sudoku {
+
+    // -------------------------------
+    // EditJournal methods - recording
+    // -------------------------------
+
+    void EditJournal::clear()
+    {
+        deltas.clear();
+        groupEnds.clear();
+        applied = 0;
+    }
+
+    std::span<const EditDelta> EditJournal::record(int cell, int before, int after)
+    {
+        if (before == after)
+            return {};
+
+        beginGroup();
+        deltas.push_back({ std::uint16_t(cell), std::uint8_t(before), std::uint8_t(after) });
+        return endGroup();
+    }
+
+    std::span<const EditDelta> EditJournal::record(const Board& before, const Board& after)
+    {
+        beginGroup();
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (before.getNumber(cell) != after.getNumber(cell))
+                deltas.push_back({ std::uint16_t(cell), std::uint8_t(before.getNumber(cell)), std::uint8_t(after.getNumber(cell)) });
+        }
+        return endGroup();
+    }
+
+    std::span<const EditDelta> EditJournal::record(std::span<const EditDelta> changes)
+    {
+        beginGroup();
+        deltas.insert(deltas.end(), changes.begin(), changes.end());
+        return endGroup();
+    }
+
+    void EditJournal::beginGroup()
+    {
+        // Undone groups can no longer be redone
+        groupEnds.resize(applied);
+        deltas.resize(applied > 0 ? groupEnds.back() : 0);
+    }
+
+    std::span<const EditDelta> EditJournal::endGroup()
+    {
+        std::uint32_t start = groupEnds.empty() ? 0 : groupEnds.back();
+        if (deltas.size() == start)
+            return {};
+
+        groupEnds.push_back(std::uint32_t(deltas.size()));
+        return group(applied++);
+    }
+
+
+    // -------------------------------
+    // EditJournal methods - undo/redo
+    // -------------------------------
+
+    std::span<const EditDelta> EditJournal::undo(Board& board)
+    {
+        if (!canUndo())
+            return {};
+
+        std::span<const EditDelta> changes = group(--applied);
+        for (auto delta = changes.rbegin(); delta != changes.rend(); ++delta)
+            board.setNumber(delta->cell, delta->before);
+
+        return changes;
+    }
+
+    std::span<const EditDelta> EditJournal::redo(Board& board)
+    {
+        if (!canRedo())
+            return {};
+
+        std::span<const EditDelta> changes = group(applied++);
+        for (const EditDelta& delta : changes)
+            board.setNumber(delta.cell, delta.after);
+
+        return changes;
+    }
+
+    void EditJournal::dropOldest(std::size_t count)
+    {
+        count = std::min(count, applied);
+        if (count == 0)
+            return;
+
+        std::uint32_t dropped = groupEnds[count - 1];
+        deltas.erase(deltas.begin(), deltas.begin() + dropped);
+        groupEnds.erase(groupEnds.begin(), groupEnds.begin() + count);
+        for (std::uint32_t& end : groupEnds)
+            end -= dropped;
+        applied -= count;
+    }
+
+    std::span<const EditDelta> EditJournal::group(std::size_t index) const
+    {
+        std::uint32_t start = index > 0 ? groupEnds[index - 1] : 0;
+        return std::span<const EditDelta>(deltas.data() + start, groupEnds[index] - start);
+    }
+
+}
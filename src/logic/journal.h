@@ -0,0 +1,68 @@
+#pragma once
+
+#include "board.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    // A single field change, packed into 4 bytes
+    struct EditDelta
+    {
+        std::uint16_t cell;         // Index of the field (see cell_index())
+        std::uint8_t before;
+        std::uint8_t after;
+
+        int row() const { return CELL_ROW[cell]; }
+        int col() const { return CELL_COL[cell]; }
+    };
+
+
+    // -----------------
+    // EditJournal class
+    // -----------------
+
+    // Undo / redo history of a board, kept as field deltas. Every recorded change forms a group - a single field
+    // for manual edits, or all the fields changed by a bulk operation (solve, generation, clear) - which is undone
+    // and redone at once. Recording a new group discards the undone ones.
+    class EditJournal
+    {
+    public:
+        void clear();
+
+        // Recording - returns the recorded group, empty if the change was ignored
+        std::span<const EditDelta> record(int cell, int before, int after);            // Ignored if the number does not change
+        std::span<const EditDelta> record(const Board& before, const Board& after);    // Difference of the whole boards, ignored if empty
+        std::span<const EditDelta> record(std::span<const EditDelta> changes);         // Already computed group, e.g. restored from a log
+
+        // Apply the group to the board and return its deltas, so that only the changed fields have to be refreshed
+        // Empty if there is nothing to undo / redo
+        std::span<const EditDelta> undo(Board& board);
+        std::span<const EditDelta> redo(Board& board);
+
+        bool canUndo() const { return applied > 0; }
+        bool canRedo() const { return applied < groupEnds.size(); }
+
+        // Access to the whole history, including the undone groups
+        std::size_t groupCount() const { return groupEnds.size(); }
+        std::size_t appliedGroups() const { return applied; }
+        std::size_t deltaCount() const { return deltas.size(); }
+        std::span<const EditDelta> group(std::size_t index) const;
+        void dropOldest(std::size_t count);     // Forgets the oldest groups (at most the applied ones), which can no longer be undone
+
+    private:
+        void beginGroup();
+        std::span<const EditDelta> endGroup();
+
+        std::vector<EditDelta> deltas;
+        std::vector<std::uint32_t> groupEnds;       // Position in deltas right after every group
+        std::size_t applied = 0;                    // Number of groups currently reflected by the board
+    };
+
+}
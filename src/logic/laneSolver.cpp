@@ -0,0 +1,140 @@
+#include "laneSolver.h"
+#include <algorithm>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    // Branch-free helpers, so that the loops over lanes can be vectorized
+    inline CandidateMask mask_if(bool condition) { return CandidateMask(-CandidateMask(condition)); }
+    inline CandidateMask single_or_zero(CandidateMask mask) { return mask & mask_if((mask & (mask - 1)) == 0); }
+
+
+    // ------------------
+    // LaneSolver methods
+    // ------------------
+
+    LaneSolver::LaneSolver(Solver* fallback)
+        : fallback(fallback)
+    {
+    }
+
+    std::size_t LaneSolver::solve(std::span<Board> boards, std::span<bool> solved)
+    {
+        std::size_t solvedCount = 0;
+
+        for (std::size_t first = 0; first < boards.size(); first += LANES) {
+            std::span<Board> group = boards.subspan(first, std::min<std::size_t>(LANES, boards.size() - first));
+
+            loadLanes(group);
+            propagate();
+
+            for (int lane = 0; lane < static_cast<int>(group.size()); lane++) {
+                solved[first + lane] = finishLane(lane, group[lane]);
+                solvedCount += solved[first + lane];
+            }
+        }
+
+        return solvedCount;
+    }
+
+    void LaneSolver::loadLanes(std::span<const Board> boards)
+    {
+        // Unused lanes are left empty - propagation does not change them
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            cells[cell].fill(ALL_CANDIDATES);
+            for (int lane = 0; lane < static_cast<int>(boards.size()); lane++) {
+                int num = boards[lane].getNumber(cell);
+                if (num != 0)
+                    cells[cell][lane] = candidate_bit(num);
+            }
+        }
+        failed.fill(0);
+    }
+
+    void LaneSolver::propagate()
+    {
+        // Every pass applies both techniques to all the units, until none of the lanes changes
+        LaneMasks changed;
+        do {
+            changed.fill(0);
+
+            for (const auto& unit : UNIT_CELLS) {
+                alignas(32) LaneMasks once = {}, twice = {}, singles = {}, repeatedSingles = {}, empty = {};
+
+                // Gather the digits already placed in the unit and digits with a single possible place
+                for (int cell : unit) {
+                    const LaneMasks& masks = cells[cell];
+                    for (int lane = 0; lane < LANES; lane++) {
+                        CandidateMask mask = masks[lane];
+                        CandidateMask single = single_or_zero(mask);
+                        repeatedSingles[lane] |= singles[lane] & single;
+                        singles[lane] |= single;
+                        twice[lane] |= once[lane] & mask;
+                        once[lane] |= mask;
+                        empty[lane] |= mask_if(mask == 0);
+                    }
+                }
+
+                // Naked singles eliminate their digit from the peers, hidden singles fix the digit of their cell
+                for (int cell : unit) {
+                    LaneMasks& masks = cells[cell];
+                    for (int lane = 0; lane < LANES; lane++) {
+                        CandidateMask mask = masks[lane];
+                        CandidateMask single = single_or_zero(mask);
+                        CandidateMask reduced = mask & ~singles[lane];
+                        CandidateMask hidden = reduced & once[lane] & ~twice[lane];
+                        CandidateMask isSingle = mask_if(single != 0), isHidden = mask_if(hidden != 0);
+                        CandidateMask updated = (single & isSingle) | (~isSingle & ((hidden & isHidden) | (reduced & ~isHidden)));
+                        changed[lane] |= updated ^ mask;
+                        masks[lane] = updated;
+                    }
+                }
+
+                // Contradictions - an empty cell, a digit placed twice or a digit without a place
+                for (int lane = 0; lane < LANES; lane++)
+                    failed[lane] |= empty[lane] | repeatedSingles[lane] | (once[lane] ^ ALL_CANDIDATES);
+            }
+
+            // Lanes which already failed are not worth further passes
+            for (int lane = 0; lane < LANES; lane++)
+                changed[lane] &= mask_if(failed[lane] == 0);
+        } while (std::any_of(changed.begin(), changed.end(), [](CandidateMask mask) { return mask != 0; }));
+    }
+
+    bool LaneSolver::finishLane(int lane, Board& board)
+    {
+        if (failed[lane]) {
+            stats.propagated++;
+            return false;
+        }
+
+        bool complete = std::all_of(cells.begin(), cells.end(), [lane](const LaneMasks& masks) {
+            return single_or_zero(masks[lane]) != 0;
+        });
+
+        // Propagation alone is not enough - continue from its result with the scalar solver
+        Board result = board;
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (CandidateMask single = single_or_zero(cells[cell][lane]))
+                result.setNumber(cell, lowest_candidate(single));
+        }
+
+        if (complete) {
+            stats.propagated++;
+            board = result;
+            return true;
+        }
+
+        stats.handedOff++;
+        if (!fallback->solve(result))
+            return false;
+
+        board = result;
+        return true;
+    }
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "candidates.h"
+#include "solver.h"
+#include <span>
+
+
+namespace Sudoku {
+
+    // ----------------
+    // LaneSolver class
+    // ----------------
+
+    // Batch solver keeping LANES puzzles in a structure-of-arrays layout (one candidate mask per cell per lane),
+    // so that constraint propagation (naked and hidden singles) runs on all of them at once across SIMD lanes.
+    // Puzzles which cannot be finished by propagation alone are handed off to the scalar solver.
+    class LaneSolver
+    {
+    public:
+        static constexpr int LANES = 16;
+
+        LaneSolver(Solver* fallback);
+
+        // Solves the boards in place and stores the outcome of each one in solved (which must be at least as long)
+        // Returns the number of solved boards
+        std::size_t solve(std::span<Board> boards, std::span<bool> solved);
+
+        // Statistics accumulated since construction
+        struct Stats
+        {
+            long propagated = 0;        // Puzzles solved (or refuted) by propagation alone
+            long handedOff = 0;         // Puzzles which required the scalar solver
+        };
+
+        const Stats& getStats() const { return stats; }
+
+    private:
+        using LaneMasks = std::array<CandidateMask, LANES>;
+
+        // Helper functions
+        void loadLanes(std::span<const Board> boards);
+        void propagate();
+        bool finishLane(int lane, Board& board);
+
+        // Candidate masks of each cell in each lane, and lanes with contradiction found
+        alignas(32) std::array<LaneMasks, CELL_COUNT> cells;
+        alignas(32) LaneMasks failed;
+
+        Solver* fallback;
+        Stats stats;
+    };
+
+}
@@ -0,0 +1,93 @@
+#include "latency.h"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+
+namespace Sudoku {
+
+    // ----------------
+    // Helper functions
+    // ----------------
+
+    std::string format_latency(std::chrono::nanoseconds latency)
+    {
+        constexpr const char* UNITS[] = { "ns", "us", "ms", "s" };
+
+        double value = static_cast<double>(latency.count());
+        int unit = 0;
+        while (value >= 1000.0 && unit < 3) {
+            value /= 1000.0;
+            unit++;
+        }
+
+        char text[32];
+        int precision = unit == 0 || value >= 100.0 ? 0 : value >= 10.0 ? 1 : 2;
+        std::snprintf(text, sizeof(text), "%.*f %s", precision, value, UNITS[unit]);
+        return text;
+    }
+
+    std::string latency_json(const LatencyHistogram::Summary& summary)
+    {
+        std::string json = "{\"samples\":" + std::to_string(summary.samples) +
+                           ",\"p50_ns\":" + std::to_string(summary.p50.count()) + ",\"p90_ns\":" + std::to_string(summary.p90.count()) +
+                           ",\"p99_ns\":" + std::to_string(summary.p99.count()) + ",\"max_ns\":" + std::to_string(summary.max.count()) +
+                           ",\"buckets\":[";
+        for (std::size_t i = 0; i < summary.buckets.size(); i++) {
+            json += (i > 0 ? ",[" : "[") + std::to_string(summary.buckets[i].first) + "," + std::to_string(summary.buckets[i].second) + "]";
+        }
+
+        return json + "]}";
+    }
+
+
+    // ------------------------
+    // LatencyHistogram methods
+    // ------------------------
+
+    void LatencyHistogram::record(std::chrono::nanoseconds latency)
+    {
+        if (samples.empty())
+            return;
+
+        samples[std::size_t(recorded) % samples.size()] = std::max<std::int64_t>(latency.count(), 0);
+        recorded++;
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other)
+    {
+        std::size_t count = std::min(std::size_t(other.recorded), other.samples.size());
+        for (std::size_t i = 0; i < count; i++)
+            record(std::chrono::nanoseconds(other.samples[i]));
+    }
+
+    LatencyHistogram::Summary LatencyHistogram::summary() const
+    {
+        Summary result;
+        result.samples = std::min(std::size_t(recorded), samples.size());
+        if (result.samples == 0)
+            return result;
+
+        // Nearest-rank percentiles of the sorted window
+        std::vector<std::int64_t> sorted(samples.begin(), samples.begin() + result.samples);
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](std::size_t p) {
+            return std::chrono::nanoseconds(sorted[std::max<std::size_t>((sorted.size() * p + 99) / 100, 1) - 1]);
+        };
+        result.p50 = percentile(50);
+        result.p90 = percentile(90);
+        result.p99 = percentile(99);
+        result.max = std::chrono::nanoseconds(sorted.back());
+
+        // Bucket k holds the latencies below 2^k ns
+        for (std::int64_t latency : sorted) {
+            std::int64_t upper = std::int64_t(1) << std::bit_width(std::uint64_t(latency));
+            if (result.buckets.empty() || result.buckets.back().first != upper)
+                result.buckets.emplace_back(upper, 0);
+            result.buckets.back().second++;
+        }
+
+        return result;
+    }
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    using LatencyClock = std::chrono::steady_clock;     // Monotonic, with (at least) microsecond resolution on all platforms
+
+    std::string format_latency(std::chrono::nanoseconds latency);     // Three significant digits with a fitting unit, e.g. 12.4 us
+
+
+    // ----------------------
+    // LatencyHistogram class
+    // ----------------------
+
+    // Rolling window of the most recent latencies - percentiles are exact over the window, and the distribution
+    // is summarized by power-of-two buckets. Not thread-safe, per-thread histograms can be merged instead.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr std::size_t DEFAULT_WINDOW = 1024;
+
+        explicit LatencyHistogram(std::size_t window = DEFAULT_WINDOW) : samples(window) {}
+
+        void record(std::chrono::nanoseconds latency);
+        void merge(const LatencyHistogram& other);      // Records the window of the other histogram
+        void clear() { recorded = 0; }
+
+        long totalRecorded() const { return recorded; }
+
+        struct Summary
+        {
+            std::size_t samples = 0;                    // Number of latencies in the window
+            std::chrono::nanoseconds p50{0}, p90{0}, p99{0}, max{0};
+            std::vector<std::pair<std::int64_t, long>> buckets;    // Upper bound (in ns) and size of every non-empty bucket
+        };
+
+        Summary summary() const;
+
+    private:
+        std::vector<std::int64_t> samples;          // Ring buffer of latencies in nanoseconds
+        long recorded = 0;
+    };
+
+    std::string latency_json(const LatencyHistogram::Summary& summary);     // Object with the count, percentiles (in ns) and buckets
+
+}
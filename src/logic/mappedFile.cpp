@@ -0,0 +1,69 @@
+#include "mappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SUDOKU_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace Sudoku {
+
+    // ------------------
+    // MappedFile methods
+    // ------------------
+
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+
+#ifdef SUDOKU_MMAP
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            return false;
+
+        struct stat status;
+        bool success = ::fstat(descriptor, &status) == 0;
+        if (success && status.st_size > 0) {
+            void* address = ::mmap(nullptr, std::size_t(status.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+            success = address != MAP_FAILED;
+            if (success) {
+                view = static_cast<const std::uint8_t*>(address);
+                length = std::size_t(status.st_size);
+                mapped = true;
+            }
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        ::close(descriptor);
+        return success;
+#else
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        view = buffer.data();
+        length = buffer.size();
+        return true;
+#endif
+    }
+
+    void MappedFile::close()
+    {
+#ifdef SUDOKU_MMAP
+        if (mapped)
+            ::munmap(const_cast<std::uint8_t*>(view), length);
+#endif
+
+        view = nullptr;
+        length = 0;
+        mapped = false;
+        buffer.clear();
+    }
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // ----------------
+    // MappedFile class
+    // ----------------
+
+    // Read-only view of a whole file - memory-mapped where the platform supports it (so that opening even a big file
+    // is immediate, and its pages are shared between processes), read into memory elsewhere
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile& other) = delete;
+        MappedFile& operator=(const MappedFile& other) = delete;
+        ~MappedFile() { close(); }
+
+        bool open(const std::string& path);         // Returns false if the file cannot be read
+        void close();
+
+        const std::uint8_t* data() const { return view; }
+        std::size_t size() const { return length; }
+
+    private:
+        const std::uint8_t* view = nullptr;
+        std::size_t length = 0;
+        bool mapped = false;
+        std::vector<std::uint8_t> buffer;           // Contents of the file, if it is not mapped
+    };
+
+}
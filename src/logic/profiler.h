@@ -0,0 +1,48 @@
+#pragma once
+
+#include "latency.h"
+
+
+namespace Sudoku {
+
+    // -----------------
+    // Profiling helpers
+    // -----------------
+
+    // Time accumulated by the scoped timers of a single section, e.g. over a frame
+    struct ProfileSlot
+    {
+        std::chrono::nanoseconds time{0};
+        long calls = 0;
+
+        void reset() { time = std::chrono::nanoseconds(0); calls = 0; }
+    };
+
+    // Adds the time spent in its scope to the given slot. A null slot disables the timer, so the cost of
+    // an inactive profiler is a single branch - sections can stay instrumented in release builds.
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(ProfileSlot* slot) : slot(slot)
+        {
+            if (slot != nullptr)
+                start = LatencyClock::now();
+        }
+
+        ~ScopedTimer()
+        {
+            if (slot != nullptr) {
+                slot->time += LatencyClock::now() - start;
+                slot->calls++;
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        ProfileSlot* slot;
+        LatencyClock::time_point start;
+    };
+
+}
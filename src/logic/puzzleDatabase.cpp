@@ -0,0 +1,429 @@
+#include "puzzleDatabase.h"
+#include "latency.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+
+
+namespace Sudoku {
+
+    // Customizable parameters
+    constexpr std::uint32_t DATABASE_MAGIC = 0x42445353;       // "SSDB"
+    constexpr std::uint32_t INDEX_MAGIC = 0x58445353;          // "SSDX"
+    constexpr std::uint16_t DATABASE_VERSION = 1;
+    constexpr std::size_t MIN_SLOT_COUNT = 1024;                // Tables are kept at most half full
+
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    using Fields = std::array<std::uint8_t, CELL_COUNT>;
+
+    // Beginning of the data file, followed by the records
+    struct DatabaseHeader
+    {
+        std::uint32_t magic;
+        std::uint16_t version;
+        std::uint16_t boardSize;
+        std::uint32_t recordSize;
+        std::uint32_t reserved;
+    };
+
+    // Beginning of the index file, followed by the canonical and exact tables (slotCount entries each) and the bands
+    struct IndexHeader
+    {
+        std::uint32_t magic;
+        std::uint16_t version;
+        std::uint16_t boardSize;
+        std::uint32_t recordSize;
+        std::uint32_t reserved;
+        std::uint64_t recordCount;          // Together with the key of the last record, ties the index to the data file
+        std::uint64_t lastKey;
+        std::uint64_t slotCount;
+        std::uint64_t bandSizes[DIFFICULTY_BANDS];
+    };
+
+    static constexpr DatabaseHeader DATABASE_HEADER = { DATABASE_MAGIC, DATABASE_VERSION, BOARD_SIZE, sizeof(PuzzleRecord), 0 };
+
+
+    // ----------------
+    // Helper functions
+    // ----------------
+
+    static Fields board_fields(const Board& board)
+    {
+        Fields fields;
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            fields[cell] = std::uint8_t(board.getNumber(cell));
+        return fields;
+    }
+
+    static Board fields_board(const Fields& fields)
+    {
+        Board board;
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            board.setNumber(cell, fields[cell]);
+        return board;
+    }
+
+    static void place(std::vector<std::uint32_t>& slots, std::uint64_t hash, std::uint32_t index)
+    {
+        std::size_t mask = slots.size() - 1;
+        std::size_t slot = hash & mask;
+        while (slots[slot] != 0)
+            slot = (slot + 1) & mask;
+        slots[slot] = index + 1;
+    }
+
+    static bool write_all(std::FILE* file, const void* data, std::size_t size)
+    {
+        return size == 0 || std::fwrite(data, size, 1, file) == 1;
+    }
+
+
+    // --------------------
+    // PuzzleRecord methods
+    // --------------------
+
+    Board PuzzleRecord::puzzleBoard() const
+    {
+        return fields_board(puzzle);
+    }
+
+    Board PuzzleRecord::solutionBoard() const
+    {
+        return fields_board(solution);
+    }
+
+
+    // ------------------------------------
+    // PuzzleDatabase methods - maintenance
+    // ------------------------------------
+
+    bool PuzzleDatabase::open(const std::string& databasePath, bool writable)
+    {
+        close();
+        path = databasePath;
+
+        auto fail = [this]() {
+            close();
+            return false;
+        };
+
+        if (writable && !std::filesystem::exists(path)) {
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file)
+                return fail();
+            bool written = write_all(file, &DATABASE_HEADER, sizeof(DATABASE_HEADER));
+            if (std::fclose(file) != 0 || !written)
+                return fail();
+        }
+
+        DatabaseHeader header;
+        if (!dataFile.open(path) || dataFile.size() < sizeof(header))
+            return fail();
+        std::memcpy(&header, dataFile.data(), sizeof(header));
+        if (std::memcmp(&header, &DATABASE_HEADER, sizeof(header)) != 0)
+            return fail();
+        mappedCount = (dataFile.size() - sizeof(header)) / sizeof(PuzzleRecord);
+
+        // Difficulties index the bands, so a corrupted one would reach outside of them
+        for (std::size_t index = 0; index < mappedCount; index++) {
+            if (record(index).difficulty >= DIFFICULTY_BANDS)
+                return fail();
+        }
+
+        if (writable) {
+            // A torn record at the end (left by a crashed writer) is dropped, so that the new ones stay aligned
+            std::error_code error;
+            std::size_t validSize = sizeof(header) + mappedCount * sizeof(PuzzleRecord);
+            if (validSize != dataFile.size())
+                std::filesystem::resize_file(path, validSize, error);
+
+            appendFile = std::fopen(path.c_str(), "ab");
+            if (error || !appendFile)
+                return fail();
+            this->writable = true;
+        }
+
+        if (!loadIndex(path + ".idx")) {
+            buildIndex(std::bit_ceil(std::max(MIN_SLOT_COUNT, 2 * size())));
+            indexChanged = true;
+        }
+
+        return true;
+    }
+
+    bool PuzzleDatabase::close()
+    {
+        // Records go to the disk before the index, which then never refers to missing ones
+        bool success = true;
+        if (appendFile) {
+            success = std::fclose(appendFile) == 0;
+            appendFile = nullptr;
+        }
+        if (writable && indexChanged)
+            success = writeIndex() && success;
+
+        dataFile.close();
+        indexFile.close();
+        mappedCount = 0;
+        appended.clear();
+        canonicalSlots = exactSlots = {};
+        ownCanonicalSlots.clear();
+        ownExactSlots.clear();
+        for (int band = 0; band < DIFFICULTY_BANDS; band++) {
+            bands[band] = {};
+            ownBands[band].clear();
+        }
+        writable = false;
+        indexChanged = false;
+
+        return success;
+    }
+
+
+    // -----------------------------------
+    // PuzzleDatabase methods - operations
+    // -----------------------------------
+
+    const PuzzleRecord* PuzzleDatabase::find(const Board& puzzle, Board* solution) const
+    {
+        // Puzzles repeated in the same form are found without the canonicalization
+        if (const PuzzleRecord* record = findExact(puzzle, board_hash(puzzle))) {
+            if (solution)
+                *solution = record->solutionBoard();
+            return record;
+        }
+
+        if (canonicalSlots.empty())
+            return nullptr;
+
+        CanonicalForm form = canonical_form(puzzle);
+        const PuzzleRecord* record = findCanonical(form, board_hash(form.board));
+        if (record && solution)
+            *solution = form.transformation.revert(record->canonical.apply(record->solutionBoard()));
+
+        return record;
+    }
+
+    PuzzleDatabase::AddResult PuzzleDatabase::add(const Board& puzzle, Solver& solver)
+    {
+        if (!writable || canonicalSlots.empty())
+            return AddResult::FAILED;
+
+        std::uint64_t hash = board_hash(puzzle);
+        if (findExact(puzzle, hash))
+            return AddResult::KNOWN;
+
+        CanonicalForm form = canonical_form(puzzle);
+        std::uint64_t key = board_hash(form.board);
+        if (findCanonical(form, key))
+            return AddResult::KNOWN;
+
+        Board solution = puzzle;
+        auto start = LatencyClock::now();
+        bool solved = solver.solve(solution);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(LatencyClock::now() - start);
+        if (!solved)
+            return AddResult::UNSOLVABLE;
+
+        Solver::Stats stats = solver.getStats();
+        Rating rating = rate(solver, puzzle);
+
+        // Padding is cleared as well, so that the same puzzles always give the same file
+        PuzzleRecord added;
+        std::memset(static_cast<void*>(&added), 0, sizeof(added));
+        added.key = key;
+        added.score = rating.score;
+        added.solveTime = std::uint64_t(elapsed.count());
+        added.placements = std::int32_t(stats.placements);
+        added.eliminations = std::int32_t(stats.eliminations);
+        added.guesses = std::int32_t(stats.guesses);
+        added.backtracks = std::int32_t(stats.backtracks);
+        added.difficulty = std::uint8_t(rating.difficulty);
+        added.unique = rating.unique;
+        added.puzzle = board_fields(puzzle);
+        added.solution = board_fields(solution);
+        added.canonical = form.transformation;
+        added.clues = std::uint16_t(CELL_COUNT - std::count(added.puzzle.begin(), added.puzzle.end(), 0));
+
+        if (!write_all(appendFile, &added, sizeof(added)) || std::fflush(appendFile) != 0)
+            return AddResult::FAILED;
+
+        appended.push_back(added);
+        insertIndex(std::uint32_t(size() - 1));
+        return AddResult::ADDED;
+    }
+
+    const PuzzleRecord& PuzzleDatabase::record(std::size_t index) const
+    {
+        if (index < mappedCount)
+            return reinterpret_cast<const PuzzleRecord*>(dataFile.data() + sizeof(DatabaseHeader))[index];
+
+        return appended[index - mappedCount];
+    }
+
+
+    // -----------------------------------------
+    // PuzzleDatabase methods - helper functions
+    // -----------------------------------------
+
+    const PuzzleRecord* PuzzleDatabase::findExact(const Board& puzzle, std::uint64_t hash) const
+    {
+        // Tables are empty only if the database is not open
+        if (exactSlots.empty())
+            return nullptr;
+
+        Fields fields = board_fields(puzzle);
+        std::size_t mask = exactSlots.size() - 1;
+        for (std::size_t slot = hash & mask; exactSlots[slot] != 0; slot = (slot + 1) & mask) {
+            const PuzzleRecord& candidate = record(exactSlots[slot] - 1);
+            if (candidate.puzzle == fields)
+                return &candidate;
+        }
+
+        return nullptr;
+    }
+
+    const PuzzleRecord* PuzzleDatabase::findCanonical(const CanonicalForm& form, std::uint64_t key) const
+    {
+        if (canonicalSlots.empty())
+            return nullptr;
+
+        std::size_t mask = canonicalSlots.size() - 1;
+        for (std::size_t slot = key & mask; canonicalSlots[slot] != 0; slot = (slot + 1) & mask) {
+            const PuzzleRecord& candidate = record(canonicalSlots[slot] - 1);
+            if (candidate.key == key && candidate.canonical.apply(candidate.puzzleBoard()) == form.board)
+                return &candidate;
+        }
+
+        return nullptr;
+    }
+
+    bool PuzzleDatabase::loadIndex(const std::string& indexPath)
+    {
+        IndexHeader header;
+        if (!indexFile.open(indexPath) || indexFile.size() < sizeof(header))
+            return false;
+        std::memcpy(&header, indexFile.data(), sizeof(header));
+
+        // Sizes are bounded first, so that the sums below cannot overflow
+        std::uint64_t bandTotal = 0;
+        for (std::uint64_t bandSize : header.bandSizes)
+            bandTotal += std::min<std::uint64_t>(bandSize, mappedCount + 1);
+
+        bool valid = header.magic == INDEX_MAGIC && header.version == DATABASE_VERSION && header.boardSize == BOARD_SIZE &&
+                     header.recordSize == sizeof(PuzzleRecord) && header.recordCount == mappedCount &&
+                     header.lastKey == (mappedCount > 0 ? record(mappedCount - 1).key : 0) &&
+                     std::has_single_bit(header.slotCount) && header.slotCount >= 2 * mappedCount && header.slotCount <= indexFile.size() &&
+                     bandTotal == mappedCount &&
+                     indexFile.size() == sizeof(header) + (2 * header.slotCount + bandTotal) * sizeof(std::uint32_t);
+        if (!valid) {
+            indexFile.close();
+            return false;
+        }
+
+        // Slots hold record indexes plus one (zero for the empty ones, which end the probes), bands hold record indexes
+        const std::uint32_t* table = reinterpret_cast<const std::uint32_t*>(indexFile.data() + sizeof(header));
+        auto validSlots = [&header](const std::uint32_t* slots) {
+            return std::all_of(slots, slots + header.slotCount, [&header](std::uint32_t slot) { return slot <= header.recordCount; }) &&
+                   std::uint64_t(std::count_if(slots, slots + header.slotCount, [](std::uint32_t slot) { return slot != 0; })) == header.recordCount;
+        };
+        const std::uint32_t* bandEntries = table + 2 * header.slotCount;
+        bool inRange = validSlots(table) && validSlots(table + header.slotCount) &&
+                       std::all_of(bandEntries, bandEntries + bandTotal, [&header](std::uint32_t index) { return index < header.recordCount; });
+        if (!inRange) {
+            indexFile.close();
+            return false;
+        }
+
+        canonicalSlots = { table, header.slotCount };
+        exactSlots = { table + header.slotCount, header.slotCount };
+        table += 2 * header.slotCount;
+        for (int band = 0; band < DIFFICULTY_BANDS; band++) {
+            bands[band] = { table, header.bandSizes[band] };
+            table += header.bandSizes[band];
+        }
+
+        // Tables of a writable database grow, so they are copied
+        if (writable) {
+            ownCanonicalSlots.assign(canonicalSlots.begin(), canonicalSlots.end());
+            ownExactSlots.assign(exactSlots.begin(), exactSlots.end());
+            canonicalSlots = ownCanonicalSlots;
+            exactSlots = ownExactSlots;
+            for (int band = 0; band < DIFFICULTY_BANDS; band++) {
+                ownBands[band].assign(bands[band].begin(), bands[band].end());
+                bands[band] = ownBands[band];
+            }
+            indexFile.close();
+        }
+
+        return true;
+    }
+
+    void PuzzleDatabase::buildIndex(std::size_t slotCount)
+    {
+        ownCanonicalSlots.assign(slotCount, 0);
+        ownExactSlots.assign(slotCount, 0);
+        for (std::vector<std::uint32_t>& band : ownBands)
+            band.clear();
+
+        for (std::uint32_t index = 0; index < size(); index++) {
+            const PuzzleRecord& indexed = record(index);
+            place(ownCanonicalSlots, indexed.key, index);
+            place(ownExactSlots, board_hash(indexed.puzzleBoard()), index);
+            ownBands[indexed.difficulty].push_back(index);
+        }
+
+        canonicalSlots = ownCanonicalSlots;
+        exactSlots = ownExactSlots;
+        for (int band = 0; band < DIFFICULTY_BANDS; band++)
+            bands[band] = ownBands[band];
+    }
+
+    void PuzzleDatabase::insertIndex(std::uint32_t index)
+    {
+        indexChanged = true;
+        if (2 * size() > ownCanonicalSlots.size()) {
+            buildIndex(2 * ownCanonicalSlots.size());
+            return;
+        }
+
+        const PuzzleRecord& indexed = record(index);
+        place(ownCanonicalSlots, indexed.key, index);
+        place(ownExactSlots, board_hash(indexed.puzzleBoard()), index);
+        ownBands[indexed.difficulty].push_back(index);
+        bands[indexed.difficulty] = ownBands[indexed.difficulty];
+    }
+
+    bool PuzzleDatabase::writeIndex() const
+    {
+        IndexHeader header = { INDEX_MAGIC, DATABASE_VERSION, BOARD_SIZE, sizeof(PuzzleRecord), 0, size(),
+                               size() > 0 ? record(size() - 1).key : 0, canonicalSlots.size(), {} };
+        for (int band = 0; band < DIFFICULTY_BANDS; band++)
+            header.bandSizes[band] = bands[band].size();
+
+        // Written aside and renamed, so that readers always map a complete index (they keep the old one until reopening)
+        std::string indexPath = path + ".idx";
+        std::string temporaryPath = indexPath + ".tmp";
+        std::FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+        if (!file)
+            return false;
+
+        bool written = write_all(file, &header, sizeof(header)) &&
+                       write_all(file, canonicalSlots.data(), canonicalSlots.size_bytes()) &&
+                       write_all(file, exactSlots.data(), exactSlots.size_bytes());
+        for (int band = 0; band < DIFFICULTY_BANDS; band++)
+            written = written && write_all(file, bands[band].data(), bands[band].size_bytes());
+        written = std::fclose(file) == 0 && written;
+
+        std::error_code error;
+        if (written)
+            std::filesystem::rename(temporaryPath, indexPath, error);
+        return written && !error;
+    }
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "canonical.h"
+#include "mappedFile.h"
+#include "rating.h"
+#include <cstdio>
+#include <deque>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    constexpr int DIFFICULTY_BANDS = int(Difficulty::INVALID);     // Only puzzles with a solution are stored
+
+    // A single puzzle of the database, stored in the file as is - so that the records can be used in place
+    struct PuzzleRecord
+    {
+        std::uint64_t key;                  // board_hash() of the canonical form
+        std::int64_t score;                 // Rating score
+        std::uint64_t solveTime;            // Of the first solve, in nanoseconds
+        std::int32_t placements;            // Statistics of the first solve
+        std::int32_t eliminations;
+        std::int32_t guesses;
+        std::int32_t backtracks;
+        std::uint16_t clues;
+        std::uint8_t difficulty;            // Difficulty value
+        std::uint8_t unique;                // 1 if the puzzle has exactly one solution
+        std::array<std::uint8_t, CELL_COUNT> puzzle;        // Fields row by row, in the form the puzzle was first added in
+        std::array<std::uint8_t, CELL_COUNT> solution;
+        Transformation canonical;           // Turns the puzzle into its canonical form
+
+        Board puzzleBoard() const;
+        Board solutionBoard() const;
+        Difficulty getDifficulty() const { return Difficulty(difficulty); }
+    };
+
+    static_assert(std::is_trivially_copyable_v<PuzzleRecord>, "Records are copied to and from the files byte by byte");
+
+
+    // --------------------
+    // PuzzleDatabase class
+    // --------------------
+
+    // Library of rated puzzles, keyed by their canonical form - a puzzle is found in any of its equivalent forms. Records
+    // are appended to a single file of fixed-size records, and the hash tables and difficulty bands are kept in an index
+    // file next to it (<path>.idx). Both are memory-mapped, so opening a database for reading costs nothing and lookups
+    // touch a few pages. Puzzles are also indexed in the form they were added in, which spares the canonicalization
+    // (the expensive part of a lookup) for the repeated ones. Lookups of a database opened for reading are thread-safe.
+    class PuzzleDatabase
+    {
+    public:
+        PuzzleDatabase() = default;
+        PuzzleDatabase(const PuzzleDatabase& other) = delete;
+        PuzzleDatabase& operator=(const PuzzleDatabase& other) = delete;
+        ~PuzzleDatabase() { close(); }
+
+        // Opens the database (a writable one is created if it does not exist). An index which does not match the records,
+        // e.g. after a writer crashed, is rebuilt in memory. Returns false if the file cannot be read or has a wrong format.
+        bool open(const std::string& path, bool writable = false);
+        bool close();               // Writes the index of a writable database, returns false on I/O errors
+
+        // Returns nullptr if the puzzle is not stored, in any of its forms. If solution is given, it receives the solution
+        // of the puzzle in the given form. Records stay valid until the database is closed.
+        const PuzzleRecord* find(const Board& puzzle, Board* solution = nullptr) const;
+
+        // Solves and rates the puzzle, unless it is already stored (only with writable databases)
+        enum class AddResult { ADDED, KNOWN, UNSOLVABLE, FAILED };
+        AddResult add(const Board& puzzle, Solver& solver);
+
+        // Records, in the order of adding
+        std::size_t size() const { return mappedCount + appended.size(); }
+        const PuzzleRecord& record(std::size_t index) const;
+        std::span<const std::uint32_t> band(Difficulty difficulty) const { return bands[int(difficulty)]; }     // Indexes of the records
+
+    private:
+        // Helper functions
+        const PuzzleRecord* findExact(const Board& puzzle, std::uint64_t hash) const;
+        const PuzzleRecord* findCanonical(const CanonicalForm& form, std::uint64_t key) const;
+        bool loadIndex(const std::string& indexPath);
+        void buildIndex(std::size_t slotCount);
+        void insertIndex(std::uint32_t index);
+        bool writeIndex() const;
+
+        std::string path;
+        bool writable = false;
+
+        // Records
+        MappedFile dataFile;
+        std::size_t mappedCount = 0;                // Records of the data file at the time of opening
+        std::deque<PuzzleRecord> appended;          // Records added since then (a deque keeps them in place)
+        std::FILE* appendFile = nullptr;
+
+        // Index - open addressing tables of record index + 1 (0 for empty slots), in place in the index file or owned
+        MappedFile indexFile;
+        std::span<const std::uint32_t> canonicalSlots, exactSlots;
+        std::span<const std::uint32_t> bands[DIFFICULTY_BANDS];
+        std::vector<std::uint32_t> ownCanonicalSlots, ownExactSlots, ownBands[DIFFICULTY_BANDS];
+        bool indexChanged = false;
+    };
+
+}
@@ -0,0 +1,81 @@
+#include "random.h"
+#include <random>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    // Finalizer of splitmix64 - a bijection with good avalanche, used to expand and derive the seeds
+    constexpr std::uint64_t mix64(std::uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    constexpr std::uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+    constexpr std::uint64_t rotl(std::uint64_t value, int shift)
+    {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+
+    // --------------------
+    // RandomStream methods
+    // --------------------
+
+    RandomStream::RandomStream(std::uint64_t seed)
+        : seed(seed)
+    {
+        // Consecutive outputs of splitmix64 are never all zero
+        std::uint64_t sequence = seed;
+        for (std::uint64_t& word : state) {
+            sequence += GOLDEN_GAMMA;
+            word = mix64(sequence);
+        }
+    }
+
+    RandomStream::result_type RandomStream::operator()()
+    {
+        std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        std::uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+
+        return result;
+    }
+
+    int RandomStream::below(int bound)
+    {
+        // Lemire's multiply-shift on the high 32 bits, with rejection of the biased low products
+        std::uint32_t range = static_cast<std::uint32_t>(bound);
+        std::uint32_t threshold = (0u - range) % range;
+        while (true) {
+            std::uint64_t product = ((*this)() >> 32) * range;
+            if (static_cast<std::uint32_t>(product) >= threshold)
+                return static_cast<int>(product >> 32);
+        }
+    }
+
+    RandomStream RandomStream::fork(std::uint64_t index) const
+    {
+        // For a fixed parent, different indices always give different seeds (mix64 is a bijection)
+        return RandomStream(mix64(seed ^ GOLDEN_GAMMA) + mix64(index + GOLDEN_GAMMA));
+    }
+
+    std::uint64_t random_seed()
+    {
+        std::random_device device;
+        return std::uint64_t(device()) << 32 | device();
+    }
+
+}
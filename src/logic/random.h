@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+
+namespace Sudoku {
+
+    // ------------------
+    // RandomStream class
+    // ------------------
+
+    // xoshiro256** generator - 32 bytes of state and a few cycles per number. Streams are splittable: fork(i) returns
+    // a statistically independent stream, determined only by the seed of the parent and by i, so work items can get
+    // their own streams and produce the same results regardless of how they are distributed between threads.
+    // Bounded numbers and shuffles are implemented here (not with the standard distributions, which differ between
+    // library implementations), so that a seed gives the same sequence on every platform.
+    class RandomStream
+    {
+    public:
+        using result_type = std::uint64_t;
+
+        explicit RandomStream(std::uint64_t seed = 0);       // Every seed (zero included) gives a valid state
+
+        // UniformRandomBitGenerator interface
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return ~result_type(0); }
+        result_type operator()();
+
+        int below(int bound);                           // Uniform in [0, bound), bound > 0
+        int between(int low, int high) { return low + below(high - low + 1); }     // Uniform in [low, high]
+
+        template <typename Iterator>
+        void shuffle(Iterator first, Iterator last)     // Fisher-Yates, from the last element down
+        {
+            for (auto i = last - first - 1; i > 0; i--)
+                std::swap(first[i], first[below(static_cast<int>(i + 1))]);
+        }
+
+        // Splitting
+        RandomStream fork(std::uint64_t index) const;   // Does not depend on the numbers drawn from this stream so far
+        std::uint64_t getSeed() const { return seed; }
+
+    private:
+        std::array<std::uint64_t, 4> state;
+        std::uint64_t seed;
+    };
+
+    std::uint64_t random_seed();        // Non-deterministic seed, for the streams which need not be reproducible
+
+}
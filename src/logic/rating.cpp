@@ -0,0 +1,57 @@
+#include "rating.h"
+
+
+namespace Sudoku {
+
+    // Customizable parameters
+    constexpr long HARD_GUESS_LIMIT = 8;
+
+    constexpr long LOCKED_ELIMINATION_WEIGHT = 1;
+    constexpr long GUESS_WEIGHT = 20;
+    constexpr long BACKTRACK_WEIGHT = 10;
+
+
+    // -----------------
+    // Difficulty rating
+    // -----------------
+
+    Rating rate(Solver& solver, const Board& board)
+    {
+        Rating rating;
+
+        Board solution = board;
+        if (!solver.solve(solution))
+            return rating;
+
+        const Solver::Stats& stats = solver.getStats();
+        rating.score = stats.lockedEliminations * LOCKED_ELIMINATION_WEIGHT + stats.guesses * GUESS_WEIGHT +
+                       stats.backtracks * BACKTRACK_WEIGHT;
+
+        if (stats.guesses == 0)
+            rating.difficulty = stats.lockedEliminations == 0 ? Difficulty::EASY : Difficulty::MEDIUM;
+        else
+            rating.difficulty = stats.guesses <= HARD_GUESS_LIMIT ? Difficulty::HARD : Difficulty::EXPERT;
+
+        // Counting overwrites the statistics, so it goes last
+        rating.unique = solver.countSolutions(board, 2) == 1;
+
+        return rating;
+    }
+
+    const char* difficulty_name(Difficulty difficulty)
+    {
+        switch (difficulty) {
+            case Difficulty::EASY:
+                return "easy";
+            case Difficulty::MEDIUM:
+                return "medium";
+            case Difficulty::HARD:
+                return "hard";
+            case Difficulty::EXPERT:
+                return "expert";
+            default:
+                return "invalid";
+        }
+    }
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "solver.h"
+
+
+namespace Sudoku {
+
+    // -----------------
+    // Difficulty rating
+    // -----------------
+
+    enum class Difficulty : int {
+        EASY,           // Solvable with singles only
+        MEDIUM,         // Requires locked candidates, but no guessing
+        HARD,           // Requires a few guesses
+        EXPERT,         // Requires a deep search
+        INVALID         // Has no solution
+    };
+
+    struct Rating
+    {
+        Difficulty difficulty = Difficulty::INVALID;
+        long score = 0;                 // Weighted amount of work done by the solver
+        bool unique = false;            // True if the puzzle has exactly one solution
+    };
+
+    Rating rate(Solver& solver, const Board& board);
+
+    const char* difficulty_name(Difficulty difficulty);
+
+}
@@ -0,0 +1,154 @@
+#include "satSolver.h"
+#include "candidates.h"
+#include "traceSpans.h"
+
+
+namespace Sudoku {
+
+    // ------------------------------
+    // SatSolver methods - main solve
+    // ------------------------------
+
+    bool SatSolver::solve(Board& board)
+    {
+        TraceSpan span("sat solve");
+        stats = {};
+        if (!encode(board))
+            return false;
+
+        bool solved = engine.solve() == SatResult::SATISFIABLE;
+        collectStats();
+        if (!solved)
+            return false;
+
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            for (int num = 1; num <= BOARD_SIZE; num++) {
+                int var = variables[cell * BOARD_SIZE + num - 1];
+                if (var != NO_VARIABLE && engine.modelValue(var))
+                    board.setNumber(cell, num);
+            }
+        }
+
+        return true;
+    }
+
+    int SatSolver::countSolutions(const Board& board, int limit)
+    {
+        TraceSpan span("sat count solutions");
+        stats = {};
+        int solutions = 0;
+        if (!encode(board))
+            return 0;
+        bool satisfiable = true;
+
+        // Every found solution is excluded by a blocking clause before searching for the next one
+        while (satisfiable && solutions < limit && engine.solve() == SatResult::SATISFIABLE) {
+            solutions++;
+
+            clause.clear();
+            for (int var = 0; var < engine.variableCount(); var++) {
+                if (engine.modelValue(var))
+                    clause.push_back(negative_literal(var));
+            }
+            satisfiable = engine.addClause(clause);
+        }
+
+        collectStats();
+        return solutions;
+    }
+
+
+    // ----------------------------
+    // SatSolver methods - encoding
+    // ----------------------------
+
+    bool SatSolver::encode(const Board& board)
+    {
+        // Givens are not encoded at all - only the candidates left by them get variables
+        std::array<CandidateMask, CELL_COUNT> used = {};
+        int variableCount = 0;
+        variables.fill(NO_VARIABLE);
+
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            int num = board.getNumber(cell);
+            if (num == 0)
+                continue;
+            for (int peer : CELL_PEERS[cell]) {
+                if (board.getNumber(peer) == num)
+                    return false;
+                used[peer] |= candidate_bit(num);
+            }
+        }
+
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (!board.isEmpty(cell))
+                continue;
+            for (CandidateMask nums = ALL_CANDIDATES & ~used[cell]; nums != 0; nums &= nums - 1)
+                variables[cell * BOARD_SIZE + lowest_candidate(nums) - 1] = variableCount++;
+        }
+        engine.reset(variableCount);
+
+        // Every empty field holds exactly one number
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (!board.isEmpty(cell))
+                continue;
+            clause.clear();
+            for (int num = 1; num <= BOARD_SIZE; num++) {
+                int var = variables[cell * BOARD_SIZE + num - 1];
+                if (var != NO_VARIABLE)
+                    clause.push_back(positive_literal(var));
+            }
+            addExactlyOne(clause);
+        }
+
+        // Every missing number appears exactly once in every unit (both directions, to help the propagation)
+        for (int unit = 0; unit < UNIT_COUNT; unit++) {
+            CandidateMask missing = ALL_CANDIDATES;
+            for (int cell : UNIT_CELLS[unit]) {
+                if (!board.isEmpty(cell))
+                    missing &= ~candidate_bit(board.getNumber(cell));
+            }
+
+            for (; missing != 0; missing &= missing - 1) {
+                int num = lowest_candidate(missing);
+                clause.clear();
+                for (int cell : UNIT_CELLS[unit]) {
+                    int var = variables[cell * BOARD_SIZE + num - 1];
+                    if (var != NO_VARIABLE)
+                        clause.push_back(positive_literal(var));
+                }
+                addExactlyOne(clause);
+            }
+        }
+
+        return true;
+    }
+
+    void SatSolver::addExactlyOne(const std::vector<Literal>& literals)
+    {
+        // Pairwise encoding - the groups have at most BOARD_SIZE literals
+        Literal pair[2];
+        for (std::size_t i = 0; i < literals.size(); i++) {
+            for (std::size_t j = i + 1; j < literals.size(); j++) {
+                pair[0] = negate(literals[i]);
+                pair[1] = negate(literals[j]);
+                engine.addClause(pair);
+            }
+        }
+
+        engine.addClause(literals);
+    }
+
+    void SatSolver::collectStats()
+    {
+        const CdclEngine::Stats& engineStats = engine.getStats();
+        stats.variables = engine.variableCount();
+        stats.clauses = engineStats.clauses;
+        stats.decisions = engineStats.decisions;
+        stats.propagations = engineStats.propagations;
+        stats.conflicts = engineStats.conflicts;
+        stats.learnedClauses = engineStats.learnedClauses;
+        stats.restarts = engineStats.restarts;
+    }
+
+}
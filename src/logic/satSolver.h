@@ -0,0 +1,52 @@
+#pragma once
+
+#include "board.h"
+#include "cdcl.h"
+#include <array>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // ---------------
+    // SatSolver class
+    // ---------------
+
+    // Alternative solving backend with the same interface as Solver: the board is encoded as CNF and solved by
+    // the built-in CDCL engine. Pays off on hard puzzles, where the backtracking search of Solver explodes.
+    class SatSolver
+    {
+    public:
+        // Main solving methods
+        bool solve(Board& board);   // Returns true if the board was succesfully solved or false in other case
+        int countSolutions(const Board& board, int limit);      // Stops counting after reaching the limit
+
+        // Statistics of the last solve
+        struct Stats
+        {
+            long variables = 0;             // Size of the encoding (givens and their consequences are simplified away)
+            long clauses = 0;
+            long decisions = 0;
+            long propagations = 0;
+            long conflicts = 0;
+            long learnedClauses = 0;
+            long restarts = 0;
+        };
+
+        const Stats& getStats() const { return stats; }
+
+    private:
+        static constexpr int NO_VARIABLE = -1;
+
+        // Helper functions
+        bool encode(const Board& board);        // Returns false if the givens already contradict each other
+        void addExactlyOne(const std::vector<Literal>& literals);
+        void collectStats();
+
+        CdclEngine engine;
+        std::array<int, CELL_COUNT * BOARD_SIZE> variables;    // Variable of (cell, number - 1) or NO_VARIABLE
+        std::vector<Literal> clause;
+        Stats stats;
+    };
+
+}
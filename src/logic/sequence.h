@@ -0,0 +1,106 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Sequence class
+    // --------------
+
+    // Lazily evaluated sequence of values produced by a coroutine with co_yield (a minimal std::generator, which comes
+    // with C++23). The coroutine runs only when the next value is requested, and the values are passed by reference -
+    // each one stays valid until the iterator is advanced. Destroying the sequence abandons the rest of it.
+    template <typename T>
+    class Sequence
+    {
+    public:
+        struct promise_type
+        {
+            const T* current = nullptr;
+            std::exception_ptr exception;
+
+            Sequence get_return_object() { return Sequence(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() { exception = std::current_exception(); }
+
+            std::suspend_always yield_value(const T& value) noexcept
+            {
+                current = std::addressof(value);
+                return {};
+            }
+
+            // Sequences only yield values
+            template <typename Awaitable>
+            std::suspend_never await_transform(Awaitable&& awaitable) = delete;
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+        class Iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(Handle handle) : handle(handle) {}
+
+            const T& operator*() const { return *handle.promise().current; }
+            const T* operator->() const { return handle.promise().current; }
+            Iterator& operator++() { resume(handle); return *this; }
+            void operator++(int) { ++*this; }
+            bool operator==(std::default_sentinel_t) const { return !handle || handle.done(); }
+
+        private:
+            Handle handle;
+        };
+
+        Sequence(Sequence&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        Sequence& operator=(Sequence&& other) noexcept
+        {
+            if (this != &other) {
+                if (handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, {});
+            }
+            return *this;
+        }
+        ~Sequence()
+        {
+            if (handle)
+                handle.destroy();
+        }
+
+        // Single pass - begin() runs the coroutine up to the first value
+        Iterator begin()
+        {
+            if (handle)
+                resume(handle);
+            return Iterator(handle);
+        }
+        std::default_sentinel_t end() const { return {}; }
+
+    private:
+        explicit Sequence(Handle handle) : handle(handle) {}
+
+        // Exceptions thrown by the coroutine reach the consumer
+        static void resume(Handle handle)
+        {
+            handle.resume();
+            if (handle.promise().exception)
+                std::rethrow_exception(std::exchange(handle.promise().exception, nullptr));
+        }
+
+        Handle handle;
+    };
+
+}
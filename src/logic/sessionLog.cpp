@@ -0,0 +1,301 @@
+#include "sessionLog.h"
+#include <filesystem>
+#include <utility>
+
+
+namespace Sudoku {
+
+    // Customizable parameters
+    constexpr std::uint16_t SESSION_MAGIC = 0x5344;
+    constexpr std::uint8_t SESSION_VERSION = 2;        // Logs of version 1 (without SNAPSHOT_END) are still restored
+
+
+    // ----------------
+    // Helper functions
+    // ----------------
+
+    static std::uint8_t record_checksum(const SessionRecord& record)
+    {
+        return std::uint8_t(0x5A ^ (record.cell & 0xFF) ^ (record.cell >> 8) ^ record.before ^ record.after ^ std::uint8_t(record.type));
+    }
+
+    static SessionRecord make_record(SessionRecordType type, int cell, int before, int after)
+    {
+        SessionRecord record = { std::uint16_t(cell), std::uint8_t(before), std::uint8_t(after), type, 0, SESSION_MAGIC };
+        record.checksum = record_checksum(record);
+        return record;
+    }
+
+    static bool is_valid(const SessionRecord& record)
+    {
+        bool isField = record.type == SessionRecordType::DELTA || record.type == SessionRecordType::BASE;
+        return record.magic == SESSION_MAGIC && record.checksum == record_checksum(record) &&
+               (!isField || (record.cell < CELL_COUNT && record.before <= BOARD_SIZE && record.after <= BOARD_SIZE));
+    }
+
+
+    // --------------------------------
+    // SessionLog methods - maintenance
+    // --------------------------------
+
+    bool SessionLog::open(const std::string& logPath, Board& board, EditJournal& journal)
+    {
+        close();
+        path = logPath;
+        stats = {};
+        appendedRecords = 0;
+
+        long logSize = 0;
+        if (std::FILE* existing = std::fopen(path.c_str(), "rb")) {
+            std::fseek(existing, 0, SEEK_END);
+            logSize = std::ftell(existing);
+            std::fclose(existing);
+        }
+        stats.restoredRecords = restore(path, board, journal);
+        appendedRecords = stats.appendedRecords;
+
+        // New logs, damaged ones (e.g. after a crash in the middle of a write) and the ones which missed a snapshot
+        // are replaced with a snapshot right away. The size of a snapshot is bounded by HISTORY_LIMIT, so it does
+        // not count here - otherwise a long history would be compacted again on every launch.
+        bool damaged = stats.restoredRecords == 0 || logSize != stats.restoredRecords * long(sizeof(SessionRecord));
+        if (damaged || stats.appendedRecords >= SNAPSHOT_INTERVAL) {
+            trimHistory(journal);
+            if (!replaceLog(snapshotRecords(board, journal)))
+                return false;
+            stats.compacted = true;
+            appendedRecords = 0;
+        }
+
+        file = std::fopen(path.c_str(), "ab");
+        if (!file)
+            return false;
+
+        stopping = false;
+        persisting = true;
+        writer = std::thread(&SessionLog::writerLoop, this);
+        return true;
+    }
+
+    void SessionLog::close()
+    {
+        if (!persisting)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        available.notify_one();
+        writer.join();
+
+        if (file)
+            std::fclose(file);
+        file = nullptr;
+        persisting = false;
+    }
+
+    long SessionLog::restore(const std::string& path, Board& board, EditJournal& journal)
+    {
+        board.clear();
+        journal.clear();
+
+        std::FILE* input = std::fopen(path.c_str(), "rb");
+        if (!input)
+            return 0;
+
+        // The whole log is read at once - replaying it takes just a few operations per record
+        std::vector<SessionRecord> records;
+        std::fseek(input, 0, SEEK_END);
+        records.resize(std::size_t(std::ftell(input)) / sizeof(SessionRecord));
+        std::fseek(input, 0, SEEK_SET);
+        records.resize(std::fread(records.data(), sizeof(SessionRecord), records.size(), input));
+        std::fclose(input);
+
+        // Logs of other board sizes or formats are ignored
+        if (records.empty() || !is_valid(records[0]) || records[0].type != SessionRecordType::HEADER ||
+            records[0].cell != BOARD_SIZE || records[0].before == 0 || records[0].before > SESSION_VERSION)
+            return 0;
+
+        std::vector<EditDelta> group;
+        long valid = 1, snapshotEnd = 1;
+        for (long i = 1; i < long(records.size()) && is_valid(records[i]); i++) {
+            const SessionRecord& record = records[i];
+            if (record.type == SessionRecordType::DELTA) {
+                group.push_back({ record.cell, record.before, record.after });
+                continue;
+            }
+
+            if (record.type == SessionRecordType::BASE)
+                board.setNumber(record.cell, record.after);
+            else if (record.type == SessionRecordType::GROUP_END) {
+                for (const EditDelta& delta : journal.record(group))
+                    board.setNumber(delta.cell, delta.after);
+                group.clear();
+            }
+            else if (record.type == SessionRecordType::UNDO)
+                journal.undo(board);
+            else if (record.type == SessionRecordType::REDO)
+                journal.redo(board);
+            else if (record.type == SessionRecordType::SNAPSHOT_END)
+                snapshotEnd = i + 1;
+            else
+                break;
+
+            // Only complete operations count - an unfinished group is dropped
+            valid = i + 1;
+        }
+
+        stats.appendedRecords = valid - snapshotEnd;
+        return valid;
+    }
+
+    void SessionLog::trimHistory(EditJournal& journal)
+    {
+        std::size_t count = 0, dropped = 0;
+        while (count < journal.appliedGroups() && journal.deltaCount() - dropped > HISTORY_LIMIT)
+            dropped += journal.group(count++).size();
+        journal.dropOldest(count);
+    }
+
+    std::vector<SessionRecord> SessionLog::snapshotRecords(const Board& board, const EditJournal& journal)
+    {
+        // The base board is the current one with all the applied groups undone
+        Board base = board;
+        for (std::size_t i = journal.appliedGroups(); i > 0; i--) {
+            std::span<const EditDelta> changes = journal.group(i - 1);
+            for (auto delta = changes.rbegin(); delta != changes.rend(); ++delta)
+                base.setNumber(delta->cell, delta->before);
+        }
+
+        std::vector<SessionRecord> records;
+        records.push_back(make_record(SessionRecordType::HEADER, BOARD_SIZE, SESSION_VERSION, 0));
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (!base.isEmpty(cell))
+                records.push_back(make_record(SessionRecordType::BASE, cell, 0, base.getNumber(cell)));
+        }
+        for (std::size_t i = 0; i < journal.groupCount(); i++) {
+            for (const EditDelta& delta : journal.group(i))
+                records.push_back(make_record(SessionRecordType::DELTA, delta.cell, delta.before, delta.after));
+            records.push_back(make_record(SessionRecordType::GROUP_END, 0, 0, 0));
+        }
+        for (std::size_t i = journal.appliedGroups(); i < journal.groupCount(); i++)
+            records.push_back(make_record(SessionRecordType::UNDO, 0, 0, 0));
+        records.push_back(make_record(SessionRecordType::SNAPSHOT_END, 0, 0, 0));
+
+        return records;
+    }
+
+    bool SessionLog::replaceLog(const std::vector<SessionRecord>& records)
+    {
+        // The new log replaces the old one only once it is complete
+        std::string temporaryPath = path + ".tmp";
+        std::FILE* output = std::fopen(temporaryPath.c_str(), "wb");
+        if (!output)
+            return false;
+        bool written = std::fwrite(records.data(), sizeof(SessionRecord), records.size(), output) == records.size();
+        written &= std::fclose(output) == 0;
+        if (!written) {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+
+        // Replaces the old log in a single step (also on Windows, unlike std::rename), so that a crash leaves one of them
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        return !error;
+    }
+
+
+    // ------------------------------
+    // SessionLog methods - appending
+    // ------------------------------
+
+    void SessionLog::recordGroup(std::span<const EditDelta> changes)
+    {
+        if (changes.empty())
+            return;
+
+        for (const EditDelta& delta : changes)
+            append(SessionRecordType::DELTA, delta.cell, delta.before, delta.after);
+        append(SessionRecordType::GROUP_END);
+    }
+
+    void SessionLog::recordUndo()
+    {
+        append(SessionRecordType::UNDO);
+    }
+
+    void SessionLog::recordRedo()
+    {
+        append(SessionRecordType::REDO);
+    }
+
+    void SessionLog::snapshot(const Board& board, EditJournal& journal)
+    {
+        if (!persisting)
+            return;
+
+        // Records appended so far are covered by the snapshot, which is built from the copies by the writer
+        trimHistory(journal);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshotRequested = true;
+            snapshotBoard = board;
+            snapshotJournal = journal;
+            pending.clear();
+        }
+        available.notify_one();
+        appendedRecords = 0;
+    }
+
+    void SessionLog::append(SessionRecordType type, int cell, int before, int after)
+    {
+        if (!persisting)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back(make_record(type, cell, before, after));
+        }
+        available.notify_one();
+        appendedRecords++;
+    }
+
+    void SessionLog::writerLoop()
+    {
+        // Records are taken in batches, so the appending thread holds the lock only for a copy of a single record
+        std::vector<SessionRecord> batch;
+        Board board;
+        EditJournal journal;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            available.wait(lock, [this] { return stopping || !pending.empty() || snapshotRequested; });
+            if (pending.empty() && !snapshotRequested)
+                return;
+
+            bool snapshotting = std::exchange(snapshotRequested, false);
+            if (snapshotting) {
+                std::swap(board, snapshotBoard);
+                std::swap(journal, snapshotJournal);
+            }
+            batch.swap(pending);
+            lock.unlock();
+
+            // Appending continues in the replaced log (or in the old one, if it could not be replaced)
+            if (snapshotting) {
+                if (file)
+                    std::fclose(file);
+                replaceLog(snapshotRecords(board, journal));
+                file = std::fopen(path.c_str(), "ab");
+            }
+            if (file && !batch.empty()) {
+                std::fwrite(batch.data(), sizeof(SessionRecord), batch.size(), file);
+                std::fflush(file);
+            }
+            batch.clear();
+
+            lock.lock();
+        }
+    }
+
+}
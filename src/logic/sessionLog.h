@@ -0,0 +1,114 @@
+#pragma once
+
+#include "journal.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    enum class SessionRecordType : std::uint8_t {
+        HEADER,             // First record of every log, with the board size in place of the cell
+        BASE,               // A number of the board from before the recorded history (written by snapshots)
+        DELTA,              // A field change of the group being recorded
+        GROUP_END,          // Closes the group, which becomes a single undoable step
+        UNDO,
+        REDO,
+        SNAPSHOT_END        // Closes the records written by a snapshot, the ones after it have been appended
+    };
+
+    // A single log entry, packed into 8 bytes - a torn write may damage only the last record, which is then ignored
+    struct SessionRecord
+    {
+        std::uint16_t cell;
+        std::uint8_t before;
+        std::uint8_t after;
+        SessionRecordType type;
+        std::uint8_t checksum;
+        std::uint16_t magic;        // Tells the records apart from garbage
+    };
+
+
+    // ----------------
+    // SessionLog class
+    // ----------------
+
+    // Crash-safe persistence of an editing session - every change of the edit journal is appended to a file as a few
+    // fixed-size records. Appending only copies the records into a buffer, which is written by a background thread,
+    // so the caller (e.g. the render loop) never waits for the disk. Periodic snapshots replace the log with the board
+    // and its recent history, which bounds both the file size and the time of restoring it by replay.
+    class SessionLog
+    {
+    public:
+        static constexpr std::size_t HISTORY_LIMIT = 1 << 14;   // Deltas kept by snapshots, older groups can no longer be undone
+
+        SessionLog() = default;
+        SessionLog(const SessionLog& other) = delete;
+        SessionLog& operator=(const SessionLog& other) = delete;
+        ~SessionLog() { close(); }
+
+        // Restores the session stored in the file into the board and the journal (both are cleared first), and keeps
+        // appending to the file. Returns false if it cannot be written, in which case the session is not persisted.
+        bool open(const std::string& path, Board& board, EditJournal& journal);
+        void close();                       // Writes all the pending records before returning
+
+        // Appending
+        void recordGroup(std::span<const EditDelta> changes);      // Ignores empty groups
+        void recordUndo();
+        void recordRedo();
+
+        // Snapshots - the journal is trimmed to HISTORY_LIMIT deltas, so that it stays consistent with the log. Only
+        // the board and the journal are copied, the records are built and written in the background.
+        bool needsSnapshot() const { return persisting && appendedRecords >= SNAPSHOT_INTERVAL; }
+        void snapshot(const Board& board, EditJournal& journal);
+
+        // Statistics of the last open
+        struct Stats
+        {
+            long restoredRecords = 0;
+            long appendedRecords = 0;       // Restored records from after the last snapshot
+            bool compacted = false;         // True if the log has been replaced with a snapshot
+        };
+
+        const Stats& getStats() const { return stats; }
+
+    private:
+        static constexpr long SNAPSHOT_INTERVAL = 1 << 15;     // Records appended after the last snapshot
+
+        // Helper functions
+        long restore(const std::string& path, Board& board, EditJournal& journal);     // Returns the number of valid records
+        static void trimHistory(EditJournal& journal);
+        static std::vector<SessionRecord> snapshotRecords(const Board& board, const EditJournal& journal);
+        bool replaceLog(const std::vector<SessionRecord>& records);
+        void append(SessionRecordType type, int cell = 0, int before = 0, int after = 0);
+        void writerLoop();
+
+        std::string path;
+        bool persisting = false;
+        long appendedRecords = 0;
+
+        // Shared with the writer thread
+        std::FILE* file = nullptr;                  // Owned by the writer while it is running
+        std::vector<SessionRecord> pending;         // Records not handed to the writer yet
+        bool snapshotRequested = false;             // Replaces the whole log before the pending records are written
+        Board snapshotBoard;
+        EditJournal snapshotJournal;
+        std::thread writer;
+        std::mutex mutex;
+        std::condition_variable available;
+        bool stopping = false;
+
+        Stats stats;
+    };
+
+}
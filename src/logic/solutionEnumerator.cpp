@@ -0,0 +1,167 @@
+#include "solutionEnumerator.h"
+#include <algorithm>
+
+
+namespace Sudoku {
+
+    // ---------------------------------
+    // SolutionEnumerator methods - main
+    // ---------------------------------
+
+    Sequence<Board> SolutionEnumerator::solutions(Board board, std::uint64_t skip, std::uint64_t limit)
+    {
+        stats = {};
+        if (limit == 0)
+            co_return;
+
+        Frame& root = frame(0);
+        root.state.candidates.fill(ALL_CANDIDATES);
+        root.state.placed.reset();
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (!board.isEmpty(cell) && !assign(root.state, cell, board.getNumber(cell)))
+                co_return;
+        }
+
+        // Every frame is entered once (propagation and the choice of the field), and then left once for every guess
+        int depth = 0;
+        bool entered = true;
+        while (depth >= 0) {
+            Frame& current = frame(depth);
+            if (entered) {
+                entered = false;
+                current.cell = -1;
+                current.options = 0;
+
+                if (!propagate(current.state))
+                    stats.deadEnds++;
+                else if ((current.cell = selectField(current.state)) >= 0)
+                    current.options = current.state.candidates[current.cell];
+                else if (stats.skipped < skip)
+                    stats.skipped++;
+                else {
+                    for (int cell = 0; cell < CELL_COUNT; cell++)
+                        solution.setNumber(cell, lowest_candidate(current.state.candidates[cell]));
+                    stats.yielded++;
+                    co_yield solution;
+
+                    if (stats.yielded >= limit)
+                        co_return;
+                }
+            }
+
+            if (current.options == 0) {
+                depth--;
+                continue;
+            }
+
+            int num = lowest_candidate(current.options);
+            current.options &= current.options - 1;
+            stats.guesses++;
+
+            Frame& next = frame(depth + 1);
+            next.state = current.state;
+            if (assign(next.state, current.cell, num)) {
+                depth++;
+                entered = true;
+                stats.maxDepth = std::max(stats.maxDepth, depth);
+            }
+            else
+                stats.deadEnds++;
+        }
+    }
+
+
+    // ------------------------------------
+    // SolutionEnumerator methods - helpers
+    // ------------------------------------
+
+    bool SolutionEnumerator::assign(SearchState& state, int cell, int num) const
+    {
+        if (!(state.candidates[cell] & candidate_bit(num)))
+            return false;
+
+        // Fields becoming naked singles are placed in turn
+        std::array<CellIndex, CELL_COUNT> pending;
+        int pendingCount = 0;
+
+        state.candidates[cell] = candidate_bit(num);
+        pending[pendingCount++] = CellIndex(cell);
+
+        while (pendingCount > 0) {
+            int current = pending[--pendingCount];
+            if (state.placed[current])
+                continue;
+            state.placed[current] = true;
+
+            CandidateMask bit = state.candidates[current];
+            for (int peer : CELL_PEERS[current]) {
+                CandidateMask& options = state.candidates[peer];
+                if (!(options & bit))
+                    continue;
+
+                options &= ~bit;
+                if (options == 0)
+                    return false;
+                if (candidate_count(options) == 1 && !state.placed[peer] && pendingCount < CELL_COUNT)
+                    pending[pendingCount++] = CellIndex(peer);
+            }
+        }
+
+        return true;
+    }
+
+    bool SolutionEnumerator::propagate(SearchState& state) const
+    {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+
+            // Hidden singles - a number with only one place left in a unit
+            for (const CellList& unit : UNIT_CELLS) {
+                CandidateMask once = 0, twice = 0;
+                for (int cell : unit) {
+                    twice |= once & state.candidates[cell];
+                    once |= state.candidates[cell];
+                }
+                if (once != ALL_CANDIDATES)
+                    return false;
+
+                CandidateMask hidden = once & ~twice;
+                for (int cell : unit) {
+                    CandidateMask single = state.candidates[cell] & hidden;
+                    if (single == 0 || state.placed[cell])
+                        continue;
+                    if (candidate_count(single) > 1 || !assign(state, cell, lowest_candidate(single)))
+                        return false;
+                    changed = true;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    int SolutionEnumerator::selectField(const SearchState& state) const
+    {
+        // Field with the least candidates
+        int bestCell = -1, bestKey = BOARD_SIZE + 1;
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            int key = candidate_count(state.candidates[cell]);
+            if (!state.placed[cell] && key < bestKey) {
+                bestCell = cell;
+                bestKey = key;
+            }
+        }
+
+        return bestCell;
+    }
+
+    SolutionEnumerator::Frame& SolutionEnumerator::frame(int depth)
+    {
+        if (depth == static_cast<int>(arena.size()))
+            arena.emplace_back();
+
+        return arena[depth];
+    }
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "candidates.h"
+#include "sequence.h"
+#include <bitset>
+#include <cstdint>
+#include <deque>
+#include <limits>
+
+
+namespace Sudoku {
+
+    // ------------------------
+    // SolutionEnumerator class
+    // ------------------------
+
+    // Streams all the solutions of a board, one by one - e.g. the completions of an almost empty board, which are far too
+    // many to be collected. The search is a depth-first one with naked and hidden singles, driven by an explicit stack
+    // of search states (one per guess), so that it can be suspended after every solution and its memory is bounded by
+    // the search depth. Solutions come in a fixed order (fields with the least candidates first, numbers ascending).
+    class SolutionEnumerator
+    {
+    public:
+        static constexpr std::uint64_t NO_LIMIT = std::numeric_limits<std::uint64_t>::max();
+
+        // The first skip solutions are passed over without suspending the search, and at most limit are yielded.
+        // The enumerator must outlive the sequence, and can run only one sequence at a time.
+        Sequence<Board> solutions(Board board, std::uint64_t skip = 0, std::uint64_t limit = NO_LIMIT);
+
+        // Statistics of the current (or last) sequence
+        struct Stats
+        {
+            std::uint64_t yielded = 0;
+            std::uint64_t skipped = 0;
+            long guesses = 0;
+            long deadEnds = 0;              // Guesses and propagations which led to a contradiction
+            int maxDepth = 0;               // Deepest level of the search stack
+        };
+
+        const Stats& getStats() const { return stats; }
+
+    private:
+        struct SearchState
+        {
+            Possibilities candidates;
+            std::bitset<CELL_COUNT> placed;
+        };
+
+        // Level of the search stack - the state before the guess, and the numbers left to try in the guessed field
+        struct Frame
+        {
+            SearchState state;
+            int cell = -1;
+            CandidateMask options = 0;
+        };
+
+        // Helper functions
+        bool assign(SearchState& state, int cell, int num) const;      // Places the number, and the naked singles it leaves
+        bool propagate(SearchState& state) const;                       // Hidden singles
+        int selectField(const SearchState& state) const;                // -1 if all the fields are placed
+        Frame& frame(int depth);
+
+        std::deque<Frame> arena;        // Grows with the search depth and is kept for the next sequences (a deque keeps it in place)
+        Board solution;
+        Stats stats;
+    };
+
+}
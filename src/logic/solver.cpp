@@ -1,5 +1,8 @@
 #include "solver.h"
+#include "allocationCounter.h"
+#include "traceSpans.h"
 #include <algorithm>
+#include <cassert>
 
 
 namespace Sudoku {
@@ -10,63 +13,116 @@ namespace Sudoku {
 
     enum CommonLine : int { NO_LINE = -1, NO_COMMON_LINE = -2};
 
+    constexpr int DEAD_END = -1;
+
+    constexpr int MAX_SEARCH_DEPTH = CELL_COUNT + 1;      // Every level of recursion fills at least one field
+
 
     // ---------------------------
     // Solver methods - main solve
     // ---------------------------
 
     // Public part
+    Solver::Solver()
+        : arena(MAX_SEARCH_DEPTH)
+    {
+    }
+
     bool Solver::solve(Board& board)
     {
-        // Check if the board is already unsolvable
-        if (!board.isCorrect())
-            return false;
-        
-        // Process data in initial position
-        initialialProcessing(board);
+        return run(board, 1);
+    }
+
+    int Solver::countSolutions(const Board& board, int limit)
+    {
+        // Search operates on a copy, since every found solution is reverted to continue with the next branch
+        Board copy = board;
+        run(copy, limit);
 
-        // Start solving
-        return solve(board, 0);
+        return solutionsFound;
     }
 
     // Private part
+    bool Solver::run(Board& board, int limit)
+    {
+        TraceSpan span(limit == 1 ? "solve" : "count solutions");
+        stats = {};
+        solutionLimit = limit;
+        solutionsFound = 0;
+        if (trace)
+            trace->clear();
+
+        long allocationsBefore = thread_allocation_count();
+
+        // The initial position is needed only to restart the search
+        Board initial = board;
+        int restart = 0;
+        if (heuristic)
+            heuristic->start(restart);
+
+        // Check if the board is already unsolvable, otherwise process data in initial position and start solving
+        bool result = board.isCorrect();
+        while (result) {
+            restartBacktracks = stats.backtracks;
+            restartPending = false;
+
+            initialialProcessing(board);
+            result = solve(board, 0);
+            if (!restartPending)
+                break;
+
+            // Start over, with the trace describing only the last attempt
+            board = initial;
+            stats.restarts++;
+            if (trace)
+                trace->clear();
+            heuristic->start(++restart);
+            result = true;
+        }
+
+        stats.allocations = thread_allocation_count() - allocationsBefore;
+        return result;
+    }
+
     bool Solver::solve(Board& board, int depth)
     {
         // Stage 1 - cutting the positibilities
+        TraceSpan propagationSpan("propagation");
+        propagationSpan.addArg("depth", depth);
 
         // We iterate over inner squares as long as there is some potential forced fill that could limit the number of possible further fills
         int is = findBestSquare();
         while (!innerSquares[is].isFilled() && !innerSquares[is].isEvaluated()) {
-            auto [r0, c0] = Board::innerSquareTopLeft(is);
-
             // It's important to create a copy of numbers to prevent any bugs connected with changing the structure during iteration
-            std::set<int> nums = innerSquares[is].numsToEvaluate;
-            innerSquares[is].numsToEvaluate.clear();
+            CandidateMask nums = innerSquares[is].numsToEvaluate;
+            innerSquares[is].numsToEvaluate = 0;
+
+            for (; nums != 0; nums &= nums - 1) {
+                int num = lowest_candidate(nums);
 
-            for (int num : nums) {
                 // Try to find common row or column which must certainly contain the given number in the correct completion
                 int cr = NO_LINE, cc = NO_LINE;
-                for (int i = 0; i < INNER_SQUARE_SIZE; i++) {
-                    for (int j = 0; j < INNER_SQUARE_SIZE; j++) {
-                        int r = r0 + i, c = c0 + j;
-                        if (possibilities[r][c].contains(num)) {
-                            cr = cr != r && cr != NO_LINE ? NO_COMMON_LINE : r;
-                            cc = cc != c && cc != NO_LINE ? NO_COMMON_LINE : c;
-                        }
+                for (int cell : box_cells(is)) {
+                    if (possibilities[cell] & candidate_bit(num)) {
+                        int r = CELL_ROW[cell], c = CELL_COL[cell];
+                        cr = cr != r && cr != NO_LINE ? NO_COMMON_LINE : r;
+                        cc = cc != c && cc != NO_LINE ? NO_COMMON_LINE : c;
                     }
                 }
 
                 bool result = true;
                 
                 // Case 1 - found both common rank and common file, which means there is exactly one field possible for given number
-                if (cr != NO_LINE && cr != NO_COMMON_LINE && cc != NO_COMMON_LINE)
-                    result = result && setNumber(board, cr, cc, num);
+                if (cr != NO_LINE && cr != NO_COMMON_LINE && cc != NO_COMMON_LINE) {
+                    record(TraceEventType::PLACEMENT, Technique::BOX_SINGLE, cell_index(cr, cc), num);
+                    result = result && setNumber(board, cell_index(cr, cc), num);
+                }
                 // Case 2 - found only common rank, which means the number must be filled inside this rank of processed inner square
                 else if (cr != NO_LINE && cr != NO_COMMON_LINE)
-                    result = result && updatePossibilities<ROW>(board, cr, is, num);
+                    result = result && updatePossibilities<ROW>(board, cr, is, num, Technique::LOCKED_CANDIDATES);
                 // Case 3 - similarly to case 2, only for file instead of rank
                 else if (cc != NO_LINE && cc != NO_COMMON_LINE)
-                    result = result && updatePossibilities<COL>(board, cc, is, num);
+                    result = result && updatePossibilities<COL>(board, cc, is, num, Technique::LOCKED_CANDIDATES);
 
                 if (!result)
                     return false;
@@ -74,30 +130,77 @@ namespace Sudoku {
 
             is = findBestSquare();
         }
+        propagationSpan.end();
 
         // Stage 2 - guess-work when no forced moves are possible
         
-        auto [r, c] = findBestField();
+        int cell = findBestField(board);
+
+        // An empty field without any possible fill means that some of the previous guesses was wrong
+        if (cell == DEAD_END)
+            return false;
         
-        // If the field is not empty, then the whole board is completed and we can return true
-        if (!board.isEmpty(r, c))
-            return true;
+        // If the field is not empty, then the whole board is completed
+        // Unless we are looking for more solutions, we can return true
+        if (!board.isEmpty(cell))
+            return ++solutionsFound >= solutionLimit;
+
+        // A field with only one possibility does not require any guess-work, and so no state saving
+        if (candidate_count(possibilities[cell]) == 1) {
+            int num = lowest_candidate(possibilities[cell]);
+            record(TraceEventType::PLACEMENT, Technique::NAKED_SINGLE, cell, num);
+            return setNumber(board, cell, num) && solve(board, depth + 1);
+        }
         
-        // Copy all the necessary data structures to easily restore their state in case of failure in next branch
-        auto boardSave = board;
-        auto innerSquaresSave = innerSquares;
-        auto possibilitiesSave = possibilities;
+        // Let the heuristic choose the field and order of values, if there is one
+        std::array<int, BOARD_SIZE> values;
+        int valueCount = 0;
+        if (heuristic) {
+            SearchContext context = searchContext(board);
+            cell = heuristic->selectField(context);
+            valueCount = heuristic->orderValues(context, cell, values);
+        }
+        else {
+            for (CandidateMask options = possibilities[cell]; options != 0; options &= options - 1)
+                values[valueCount++] = lowest_candidate(options);
+        }
 
-        for (int num : possibilitiesSave[r][c]) {
-            bool result = setNumber(board, r, c, num) && solve(board, depth + 1);
+        // Copy all the necessary data structures to easily restore their state in case of failure in next branch
+        // Each depth has its own, preallocated slot in the arena
+        assert(depth < MAX_SEARCH_DEPTH);
+        SearchState& save = arena[depth];
+        save.board = board;
+        save.innerSquares = innerSquares;
+        save.possibilities = possibilities;
+
+        for (int i = 0; i < valueCount; i++) {
+            int num = values[i];
+            record(TraceEventType::GUESS, Technique::GUESS, cell, num);
+            bool result;
+            {
+                TraceSpan span("guess");
+                span.addArg("cell", cell);
+                span.addArg("value", num);
+                result = setNumber(board, cell, num) && solve(board, depth + 1);
+            }
 
             if (result)
                 return true;
+            else if (restartPending || stats.abandoned)
+                return false;
             else {
+                record(TraceEventType::BACKTRACK, Technique::NONE, cell, num);
+                if (backtrackLimit != 0 && stats.backtracks >= backtrackLimit) {
+                    stats.abandoned = true;
+                    return false;
+                }
+                if (heuristic && shouldRestart(board))
+                    return false;
+
                 // Restore data before trying another branch
-                board = boardSave;
-                innerSquares = innerSquaresSave;
-                possibilities = possibilitiesSave;
+                board = save.board;
+                innerSquares = save.innerSquares;
+                possibilities = save.possibilities;
             }
         }
 
@@ -111,27 +214,32 @@ namespace Sudoku {
 
     void Solver::initialialProcessing(const Board& board)
     {
+        TraceSpan span("initialialProcessing");
+        std::array<CandidateMask, BOARD_SIZE> rowUsed = {}, colUsed = {}, boxUsed = {};
+
         // Calculate inner square properties
         for (int is = 0; is < BOARD_SIZE; is++) {
             innerSquares[is].emptySquares = 0;
-            innerSquares[is].numsToEvaluate = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-
-            auto [r0, c0] = Board::innerSquareTopLeft(is);
-            for (int i = 0; i < INNER_SQUARE_SIZE; i++) {
-                for (int j = 0; j < INNER_SQUARE_SIZE; j++) {
-                    int r = r0 + i, c = c0 + j;
-                    if (board.isEmpty(r, c))
-                        innerSquares[is].emptySquares++;
-                    else
-                        innerSquares[is].numsToEvaluate.erase(board.getNumber(r, c));
+            innerSquares[is].numsToEvaluate = ALL_CANDIDATES;
+
+            for (int cell : box_cells(is)) {
+                if (board.isEmpty(cell)) {
+                    innerSquares[is].emptySquares++;
+                    continue;
                 }
+
+                CandidateMask bit = candidate_bit(board.getNumber(cell));
+                innerSquares[is].numsToEvaluate &= ~bit;
+                rowUsed[CELL_ROW[cell]] |= bit;
+                colUsed[CELL_COL[cell]] |= bit;
+                boxUsed[is] |= bit;
             }
         }
 
         // Calculate possibility map
-        for (int r = 0; r < BOARD_SIZE; r++) {
-            for (int c = 0; c < BOARD_SIZE; c++)
-                possibilities[r][c] = board.availableNumbers(r, c);
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            possibilities[cell] = board.isEmpty(cell) ? ALL_CANDIDATES & ~(rowUsed[CELL_ROW[cell]] | colUsed[CELL_COL[cell]] | boxUsed[CELL_BOX[cell]])
+                                                      : 0;
         }
     }
 
@@ -150,41 +258,39 @@ namespace Sudoku {
         return static_cast<int>(std::distance(innerSquares.begin(), resultIt));
     }
 
-    std::pair<int, int> Solver::findBestField() const
+    int Solver::findBestField(const Board& board) const
     {
-        int bestRow = 0, bestCol = 0, bestKey = 9;
-        for (int r = 0; r < BOARD_SIZE; r++) {
-            for (int c = 0; c < BOARD_SIZE; c++) {
-                int key = static_cast<int>(possibilities[r][c].size());
-                if (key < bestKey && key != 0) {
-                    bestRow = r;
-                    bestCol = c;
-                    bestKey = key;
-                }
+        int bestCell = 0, bestKey = BOARD_SIZE + 1;
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            int key = candidate_count(possibilities[cell]);
+            if (key == 0 && board.isEmpty(cell))
+                return DEAD_END;
+            if (key < bestKey && key != 0) {
+                bestCell = cell;
+                bestKey = key;
             }
         }
 
-        return { bestRow, bestCol };
+        return bestCell;
     }
 
     template <LineType lineType>
-    bool Solver::updatePossibilities(const Board& board, int line, int innerSquare, int num)
+    bool Solver::updatePossibilities(const Board& board, int line, int innerSquare, int num, Technique technique)
     {
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            int r = lineType == ROW ? line : i;
-            int c = lineType == COL ? line : i;
-            int is = board.innerSquare(r, c);
-            if (is != innerSquare && board.isEmpty(r, c) && possibilities[r][c].contains(num)) {
-                possibilities[r][c].erase(num);
-                innerSquares[is].numsToEvaluate.insert(num);
+        for (int cell : lineType == ROW ? row_cells(line) : col_cells(line)) {
+            int is = CELL_BOX[cell];
+            if (is != innerSquare && board.isEmpty(cell) && (possibilities[cell] & candidate_bit(num))) {
+                possibilities[cell] &= ~candidate_bit(num);
+                innerSquares[is].numsToEvaluate |= candidate_bit(num);
+                record(TraceEventType::ELIMINATION, technique, cell, num);
 
                 // An empty suare without possible fills indicates incorrent completion of board
-                if (possibilities[r][c].size() == 0)
+                if (possibilities[cell] == 0)
                     return false;
                 
                 // Only one possible choice, which definitely makes the inner square "alive" (not evluated)
-                if (possibilities[r][c].size() == 1)
-                    innerSquares[is].numsToEvaluate.insert(*possibilities[r][c].begin());
+                if (candidate_count(possibilities[cell]) == 1)
+                    innerSquares[is].numsToEvaluate |= possibilities[cell];
             }
         }
 
@@ -192,31 +298,84 @@ namespace Sudoku {
         return true;
     }
 
-    bool Solver::setNumber(Board& board, int r, int c, int num)
+    bool Solver::setNumber(Board& board, int cell, int num)
     {
-        int is = board.innerSquare(r, c);
+        int is = CELL_BOX[cell];
 
         // Update other inner squares
-        if (!updatePossibilities<ROW>(board, r, is, num) || !updatePossibilities<COL>(board, c, is, num))
+        if (!updatePossibilities<ROW>(board, CELL_ROW[cell], is, num, Technique::PEER_ELIMINATION) ||
+            !updatePossibilities<COL>(board, CELL_COL[cell], is, num, Technique::PEER_ELIMINATION))
             return false;
         
         // Fill the number in
-        board.setNumber(r, c, num);
+        board.setNumber(cell, num);
 
         // Update the possibilities inside current inner square
-        auto [r0, c0] = Board::innerSquareTopLeft(is);
-        for (int i = 0; i < INNER_SQUARE_SIZE; i++) {
-            for (int j = 0; j < INNER_SQUARE_SIZE; j++)
-                possibilities[r0 + i][c0 + j].erase(num);
+        for (int other : box_cells(is)) {
+            CandidateMask& options = possibilities[other];
+            if ((options & candidate_bit(num)) && other != cell)
+                record(TraceEventType::ELIMINATION, Technique::PEER_ELIMINATION, other, num);
+            options &= ~candidate_bit(num);
         }
 
         // Update current inner square
-        innerSquares[is].numsToEvaluate.insert(possibilities[r][c].begin(), possibilities[r][c].end());
-        innerSquares[is].numsToEvaluate.erase(num);
+        innerSquares[is].numsToEvaluate |= possibilities[cell];
+        innerSquares[is].numsToEvaluate &= ~candidate_bit(num);
         innerSquares[is].emptySquares--;
-        possibilities[r][c].clear();
+        possibilities[cell] = 0;
 
         return true;
     }
 
-}
\ No newline at end of file
+
+    // ---------------------------------------
+    // Solver methods - statistics and tracing
+    // ---------------------------------------
+
+    void Solver::record(TraceEventType type, Technique technique, int cell, int num)
+    {
+        switch (type) {
+            case TraceEventType::PLACEMENT:
+                stats.placements++;
+                break;
+            case TraceEventType::ELIMINATION:
+                stats.eliminations++;
+                if (technique == Technique::LOCKED_CANDIDATES)
+                    stats.lockedEliminations++;
+                break;
+            case TraceEventType::GUESS:
+                stats.guesses++;
+                break;
+            case TraceEventType::BACKTRACK:
+                stats.backtracks++;
+                break;
+        }
+
+        if (trace)
+            trace->record(TraceEvent(type, technique, cell, num));
+    }
+
+
+    // -------------------------------------
+    // Solver methods - branching heuristics
+    // -------------------------------------
+
+    SearchContext Solver::searchContext(const Board& board) const
+    {
+        return { board, possibilities, stats.guesses, stats.backtracks, stats.backtracks - restartBacktracks };
+    }
+
+    bool Solver::shouldRestart(const Board& board)
+    {
+        // Counting solutions requires an exhaustive search, which could find the same solution again after a restart
+        if (solutionLimit != 1)
+            return false;
+
+        SearchContext context = searchContext(board);
+        long limit = heuristic->restartLimit(context);
+        restartPending = limit > 0 && context.restartBacktracks >= limit;
+
+        return restartPending;
+    }
+
+}
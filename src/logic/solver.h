@@ -1,6 +1,10 @@
 #pragma once
 
 #include "board.h"
+#include "candidates.h"
+#include "heuristics.h"
+#include "trace.h"
+#include <vector>
 
 
 namespace Sudoku {
@@ -12,10 +16,37 @@ namespace Sudoku {
     class Solver
     {
     public:
-        Solver() = default;
+        Solver();
 
-        // Main solving method
+        // Main solving methods
         bool solve(Board& board);   // Returns true if the board was succesfully solved or false in other case
+        int countSolutions(const Board& board, int limit);      // Stops counting after reaching the limit
+
+        // Statistics of the last solve
+        struct Stats
+        {
+            long placements = 0;            // Numbers forced by propagation
+            long eliminations = 0;
+            long lockedEliminations = 0;    // Eliminations which required the locked candidates technique
+            long guesses = 0;
+            long backtracks = 0;
+            long restarts = 0;
+            long allocations = 0;           // Heap allocations made during the solve (counted only in builds with SUDOKU_COUNT_ALLOCATIONS)
+            bool abandoned = false;         // True if the search reached the backtrack limit (the result is then false)
+        };
+
+        const Stats& getStats() const { return stats; }
+
+        // Optional recording of solve steps (nullptr disables recording)
+        void setTrace(SolveTrace* solveTrace) { trace = solveTrace; }
+
+        // Optional branching heuristic (nullptr stands for the built-in MRV with ascending values)
+        // Restarts requested by the heuristic are ignored when counting solutions
+        void setHeuristic(BranchingHeuristic* branching) { heuristic = branching; }
+
+        // Optional limit of backtracks, after which the search is abandoned (0 stands for no limit)
+        // Bounds the worst case on the bigger boards, where some puzzles are out of reach for the backtracking search
+        void setBacktrackLimit(long limit) { backtrackLimit = limit; }
 
         // -------------
         // Local defines
@@ -23,30 +54,54 @@ namespace Sudoku {
         struct InnerSquareData
         {
             int emptySquares;
-            std::set<int> numsToEvaluate;
-
-            InnerSquareData() = default;
-            InnerSquareData(const InnerSquareData& other) = default;
-            InnerSquareData& operator=(const InnerSquareData& other) = default;
+            CandidateMask numsToEvaluate;
 
             bool isFilled() const { return emptySquares == 0; }
-            bool isEvaluated() const { return numsToEvaluate.size() == 0; }
+            bool isEvaluated() const { return numsToEvaluate == 0; }
+        };
+
+        // Everything that has to be restored after a failed guess
+        struct SearchState
+        {
+            Board board;
+            std::array<InnerSquareData, BOARD_SIZE> innerSquares;
+            Possibilities possibilities;
         };
 
     private:
         // Helper functions - solve components
+        bool run(Board& board, int limit);
         void initialialProcessing(const Board& board);
         bool solve(Board& board, int depth);
         // Helper functions - data structure handlers
         int findBestSquare() const;     // Returns an index of inner square with least number of empty squares and numbers awaiting for eval
-        std::pair<int, int> findBestField() const;  // Returns a rank and file of empty field with least number of possibilities
+        int findBestField(const Board& board) const;    // Returns an index of empty field with least number of possibilities
         template <LineType lineType>
-        bool updatePossibilities(const Board& board, int line, int innerSquare, int num);   // Dynamic update of innerSquares and possibilities
-        bool setNumber(Board& board, int r, int c, int num);    // Same as above, only it affects both row and column and fills the number in
+        bool updatePossibilities(const Board& board, int line, int innerSquare, int num,    // Dynamic update of innerSquares and possibilities
+                                 Technique technique);
+        bool setNumber(Board& board, int cell, int num);        // Same as above, only it affects both row and column and fills the number in
+        // Helper functions - statistics and tracing
+        void record(TraceEventType type, Technique technique, int cell, int num);
+        // Helper functions - branching heuristics
+        SearchContext searchContext(const Board& board) const;
+        bool shouldRestart(const Board& board);
         
         // Data structures
-        std::array<InnerSquareData, BOARD_SIZE> innerSquares;                           // State of inner n x n squares
-        std::array<std::array<std::set<int>, BOARD_SIZE>, BOARD_SIZE> possibilities;    // Map of options of how could given field be filled
+        std::array<InnerSquareData, BOARD_SIZE> innerSquares;                               // State of inner n x n squares
+        Possibilities possibilities;                                                        // Map of options of how could given field be filled (by field index)
+        std::vector<SearchState> arena;     // Saved states, one per search depth - allocated once, so that the search does not allocate
+
+        // Solve parameters and statistics
+        int solutionLimit = 1;
+        int solutionsFound = 0;
+        Stats stats;
+        SolveTrace* trace = nullptr;
+
+        // Branching heuristic state
+        BranchingHeuristic* heuristic = nullptr;
+        long restartBacktracks = 0;         // Value of stats.backtracks at the last (re)start
+        bool restartPending = false;
+        long backtrackLimit = 0;
     };
 
 }
\ No newline at end of file
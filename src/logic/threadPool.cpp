@@ -0,0 +1,76 @@
+#include "threadPool.h"
+#include "traceSpans.h"
+#include <algorithm>
+
+
+namespace Sudoku {
+
+    // ------------------
+    // ThreadPool methods
+    // ------------------
+
+    ThreadPool::ThreadPool(unsigned threads)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        // Workers started before a failure are stopped, as the destructor does not run for a throwing constructor
+        try {
+            for (unsigned i = 0; i < threads; i++)
+                workers.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        stop();
+    }
+
+    void ThreadPool::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        available.notify_all();
+
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    void ThreadPool::submit(Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        available.notify_one();
+    }
+
+    void ThreadPool::workerLoop(unsigned index)
+    {
+        name_trace_thread("worker " + std::to_string(index));
+
+        while (true) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+                // Queue is drained before stopping
+                if (tasks.empty())
+                    return;
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task(index);
+        }
+    }
+
+}
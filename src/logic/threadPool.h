@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // ----------------
+    // ThreadPool class
+    // ----------------
+
+    // A fixed set of worker threads consuming tasks from a shared queue.
+    // Tasks receive the index of the executing worker, which allows them to use per-worker (warm) state.
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void(unsigned worker)>;
+
+        explicit ThreadPool(unsigned threads = 0);      // 0 stands for the number of hardware threads
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ~ThreadPool();                                  // Finishes all the queued tasks before returning
+
+        void submit(Task task);
+        unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    private:
+        void workerLoop(unsigned index);
+        void stop();                    // Lets the workers finish the queued tasks and joins them
+
+        std::vector<std::thread> workers;
+        std::deque<Task> tasks;
+        std::mutex mutex;
+        std::condition_variable available;
+        bool stopping = false;
+    };
+
+}
@@ -0,0 +1,16 @@
+#include "trace.h"
+#include <bit>
+
+
+namespace Sudoku {
+
+    // ------------------
+    // SolveTrace methods
+    // ------------------
+
+    SolveTrace::SolveTrace(std::size_t capacity)
+        : events(std::bit_ceil(capacity < 1 ? std::size_t(1) : capacity)), mask(events.size() - 1)
+    {
+    }
+
+}
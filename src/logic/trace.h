@@ -0,0 +1,79 @@
+#pragma once
+
+#include "board.h"
+#include <cstdint>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // -----------------
+    // Solve trace types
+    // -----------------
+
+    enum class TraceEventType : std::uint8_t {
+        PLACEMENT,          // A number forced by propagation
+        ELIMINATION,        // A candidate removed from a field
+        GUESS,              // A number tried in stage 2 of the solve
+        BACKTRACK           // The last guess failed and the state from before it was restored
+    };
+
+    enum class Technique : std::uint8_t {
+        NONE,
+        BOX_SINGLE,         // The only field in an inner square that can hold the number
+        NAKED_SINGLE,       // The only number that can be filled into a field
+        LOCKED_CANDIDATES,  // The number is restricted to a single line of an inner square
+        PEER_ELIMINATION,   // The number was placed in the same row, column or inner square
+        GUESS
+    };
+
+    // A single solver step, packed into 4 bytes
+    struct TraceEvent
+    {
+        std::uint16_t cell;         // Index of the field (see cell_index())
+        std::uint8_t number;
+        std::uint8_t code;          // Event type in the high nibble, technique in the low nibble
+
+        TraceEvent() = default;
+        TraceEvent(TraceEventType type, Technique technique, int cell, int number)
+            : cell(std::uint16_t(cell)), number(std::uint8_t(number)), code(std::uint8_t(int(type) << 4 | int(technique))) {}
+        TraceEvent(TraceEventType type, Technique technique, int row, int col, int number)
+            : TraceEvent(type, technique, cell_index(row, col), number) {}
+
+        TraceEventType type() const { return TraceEventType(code >> 4); }
+        Technique technique() const { return Technique(code & 0xF); }
+        int row() const { return CELL_ROW[cell]; }
+        int col() const { return CELL_COL[cell]; }
+    };
+
+
+    // ----------------
+    // SolveTrace class
+    // ----------------
+
+    // Fixed-size ring buffer of solver events. The memory is allocated only once, in the constructor,
+    // and when the buffer gets full, the oldest events are overwritten.
+    class SolveTrace
+    {
+    public:
+        static constexpr std::size_t DEFAULT_CAPACITY = 1 << 16;
+
+        explicit SolveTrace(std::size_t capacity = DEFAULT_CAPACITY);     // Capacity is rounded up to a power of 2
+
+        void clear() { recorded = 0; }
+        void record(const TraceEvent& event) { events[recorded++ & mask] = event; }
+
+        // Access to retained events, from the oldest to the newest one
+        std::size_t size() const { return recorded < events.size() ? recorded : events.size(); }
+        const TraceEvent& operator[](std::size_t i) const { return events[(recorded - size() + i) & mask]; }
+
+        std::size_t totalRecorded() const { return recorded; }
+        bool isComplete() const { return recorded <= events.size(); }   // True if no event has been overwritten
+
+    private:
+        std::vector<TraceEvent> events;
+        std::size_t mask;
+        std::size_t recorded = 0;
+    };
+
+}
@@ -0,0 +1,185 @@
+#include "traceSpans.h"
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // Customizable parameters
+    constexpr std::size_t MAX_SPANS_PER_THREAD = 1 << 18;      // About 19 MB per thread (72-byte records), later spans of the thread are dropped
+
+    std::atomic<bool> spanTracingEnabled = false;
+
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    struct SpanRecord
+    {
+        const char* name;
+        const char* category;
+        std::int64_t start;             // Nanoseconds since TRACE_EPOCH
+        std::int64_t duration;
+        TraceSpan::Arg args[TraceSpan::MAX_ARGS];
+        int argCount;
+    };
+
+    // Spans of a single thread - the lock is contended only while the trace is written or cleared
+    struct ThreadSpans
+    {
+        std::mutex mutex;
+        std::vector<SpanRecord> spans;
+        std::string name;
+        long dropped = 0;
+        int id = 0;
+    };
+
+    const LatencyClock::time_point TRACE_EPOCH = LatencyClock::now();
+
+    // Buffers outlive their threads, so that the spans of finished workers are not lost
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadSpans>> registry;
+
+    thread_local std::shared_ptr<ThreadSpans> threadSpans;
+    thread_local std::string threadName;
+
+    ThreadSpans& thread_spans()
+    {
+        if (!threadSpans) {
+            threadSpans = std::make_shared<ThreadSpans>();
+
+            std::lock_guard<std::mutex> lock(registryMutex);
+            threadSpans->id = static_cast<int>(registry.size()) + 1;
+            threadSpans->name = threadName.empty() ? "thread " + std::to_string(threadSpans->id) : threadName;
+            registry.push_back(threadSpans);
+        }
+
+        return *threadSpans;
+    }
+
+    void append_json_string(std::string& output, const char* text)
+    {
+        output += '"';
+        for (; *text != '\0'; text++) {
+            if (*text == '"' || *text == '\\')
+                output += '\\';
+            output += *text;
+        }
+        output += '"';
+    }
+
+
+    // ----------------
+    // Span recording
+    // ----------------
+
+    void name_trace_thread(const std::string& name)
+    {
+        threadName = name;
+        if (threadSpans) {
+            std::lock_guard<std::mutex> lock(threadSpans->mutex);
+            threadSpans->name = name;
+        }
+    }
+
+    bool write_span_trace(const std::string& path)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (file == nullptr)
+            return false;
+
+        std::vector<std::shared_ptr<ThreadSpans>> threads;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            threads = registry;
+        }
+
+        // Complete ("X") events with timestamps in microseconds, preceded by the thread names
+        std::string output = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        output += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"sudoku\"}}";
+        long dropped = 0;
+        char number[64];
+
+        for (const std::shared_ptr<ThreadSpans>& thread : threads) {
+            std::lock_guard<std::mutex> lock(thread->mutex);
+            dropped += thread->dropped;
+
+            output += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(thread->id) + ",\"args\":{\"name\":";
+            append_json_string(output, thread->name.c_str());
+            output += "}}";
+
+            for (const SpanRecord& span : thread->spans) {
+                output += ",\n{\"name\":";
+                append_json_string(output, span.name);
+                output += ",\"cat\":";
+                append_json_string(output, span.category);
+                std::snprintf(number, sizeof(number), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", span.start / 1000.0, span.duration / 1000.0);
+                output += number;
+                output += ",\"pid\":1,\"tid\":" + std::to_string(thread->id);
+
+                if (span.argCount > 0) {
+                    output += ",\"args\":{";
+                    for (int i = 0; i < span.argCount; i++) {
+                        output += i > 0 ? "," : "";
+                        append_json_string(output, span.args[i].name);
+                        output += ":" + std::to_string(span.args[i].value);
+                    }
+                    output += "}";
+                }
+                output += "}";
+
+                // Keep the memory bounded on big traces
+                if (output.size() >= 1 << 20) {
+                    std::fwrite(output.data(), 1, output.size(), file);
+                    output.clear();
+                }
+            }
+        }
+
+        output += "\n],\"otherData\":{\"droppedSpans\":" + std::to_string(dropped) + "}}\n";
+        std::fwrite(output.data(), 1, output.size(), file);
+
+        bool success = std::ferror(file) == 0;
+        return std::fclose(file) == 0 && success;
+    }
+
+    void clear_span_trace()
+    {
+        std::lock_guard<std::mutex> registryLock(registryMutex);
+        for (const std::shared_ptr<ThreadSpans>& thread : registry) {
+            std::lock_guard<std::mutex> lock(thread->mutex);
+            thread->spans.clear();
+            thread->dropped = 0;
+        }
+    }
+
+
+    // -----------------
+    // TraceSpan methods
+    // -----------------
+
+    void TraceSpan::finish()
+    {
+        LatencyClock::time_point end = LatencyClock::now();
+        ThreadSpans& thread = thread_spans();
+
+        std::lock_guard<std::mutex> lock(thread.mutex);
+        if (thread.spans.size() >= MAX_SPANS_PER_THREAD) {
+            thread.dropped++;
+            return;
+        }
+
+        SpanRecord& span = thread.spans.emplace_back();
+        span.name = name;
+        span.category = category;
+        span.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - TRACE_EPOCH).count();
+        span.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        span.argCount = argCount;
+        for (int i = 0; i < argCount; i++)
+            span.args[i] = args[i];
+    }
+
+}
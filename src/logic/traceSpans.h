@@ -0,0 +1,89 @@
+#pragma once
+
+#include "latency.h"
+#include <atomic>
+#include <string>
+
+
+namespace Sudoku {
+
+    // ---------------
+    // Span recording
+    // ---------------
+
+    // Process-wide switch of the span recording, off by default. Spans of every thread are kept in memory
+    // until they are written as a Chrome trace event file (chrome://tracing or https://ui.perfetto.dev).
+    extern std::atomic<bool> spanTracingEnabled;
+
+    inline bool span_tracing_enabled() { return spanTracingEnabled.load(std::memory_order_relaxed); }
+    inline void set_span_tracing(bool enabled) { spanTracingEnabled.store(enabled, std::memory_order_relaxed); }
+
+    void name_trace_thread(const std::string& name);        // Label of the calling thread in the trace (by default "thread <n>")
+    bool write_span_trace(const std::string& path);         // Writes all the spans recorded so far, returns false on I/O errors
+    void clear_span_trace();
+
+
+    // ---------------
+    // TraceSpan class
+    // ---------------
+
+    // Records the time spent in its scope as a single span of the calling thread. Names, categories and argument names
+    // must be string literals. With the recording disabled, the cost is a relaxed load and a branch.
+    class TraceSpan
+    {
+    public:
+        static constexpr int MAX_ARGS = 2;
+
+        explicit TraceSpan(const char* name, const char* category = "solver")
+        {
+            if (span_tracing_enabled()) {
+                this->name = name;
+                this->category = category;
+                start = LatencyClock::now();
+            }
+        }
+
+        ~TraceSpan()
+        {
+            if (name != nullptr)
+                finish();
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+        // Ends the span before leaving the scope
+        void end()
+        {
+            if (name != nullptr) {
+                finish();
+                name = nullptr;
+            }
+        }
+
+        // Integer argument shown with the span - e.g. the search depth or the guessed cell
+        void addArg(const char* argName, long value)
+        {
+            if (name != nullptr && argCount < MAX_ARGS) {
+                args[argCount].name = argName;
+                args[argCount++].value = value;
+            }
+        }
+
+        struct Arg
+        {
+            const char* name;
+            long value;
+        };
+
+    private:
+        void finish();
+
+        const char* name = nullptr;             // Null if the recording was disabled when the span started
+        const char* category = nullptr;
+        LatencyClock::time_point start;
+        Arg args[MAX_ARGS];
+        int argCount = 0;
+    };
+
+}
@@ -0,0 +1,116 @@
+#include "validation.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    using LaneMasks = std::array<CandidateMask, VALIDATION_LANES>;
+
+    // Bit of every byte value, none for empty fields and values out of range - then the unit cannot be complete
+    // (a lookup, as SSE2 has no variable shifts of 16-bit elements)
+    constexpr std::array<CandidateMask, 256> NUMBER_BITS = []() {
+        std::array<CandidateMask, 256> bits = {};
+        for (int num = 1; num <= BOARD_SIZE; num++)
+            bits[num] = candidate_bit(num);
+        return bits;
+    }();
+
+    // Validates VALIDATION_LANES grids at once and returns a bitmask of the valid lanes
+    unsigned validate_lanes(const std::uint8_t* grids)
+    {
+        alignas(32) std::array<LaneMasks, BOARD_SIZE> rows = {}, cols = {}, boxes = {};
+        alignas(32) LaneMasks bits;
+
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            for (int lane = 0; lane < VALIDATION_LANES; lane++)
+                bits[lane] = NUMBER_BITS[grids[lane * CELL_COUNT + cell]];
+
+            LaneMasks& row = rows[CELL_ROW[cell]];
+            LaneMasks& col = cols[CELL_COL[cell]];
+            LaneMasks& box = boxes[CELL_BOX[cell]];
+            for (int lane = 0; lane < VALIDATION_LANES; lane++) {
+                row[lane] |= bits[lane];
+                col[lane] |= bits[lane];
+                box[lane] |= bits[lane];
+            }
+        }
+
+        // BOARD_SIZE fields cover all the BOARD_SIZE numbers only if none of them repeats
+        alignas(32) LaneMasks complete;
+        complete.fill(ALL_CANDIDATES);
+        for (int unit = 0; unit < BOARD_SIZE; unit++) {
+            for (int lane = 0; lane < VALIDATION_LANES; lane++)
+                complete[lane] &= rows[unit][lane] & cols[unit][lane] & boxes[unit][lane];
+        }
+
+        unsigned validLanes = 0;
+        for (int lane = 0; lane < VALIDATION_LANES; lane++)
+            validLanes |= unsigned(complete[lane] == ALL_CANDIDATES) << lane;
+        return validLanes;
+    }
+
+
+    // --------------------
+    // Bulk grid validation
+    // --------------------
+
+    std::size_t validate_grids(std::span<const std::uint8_t> grids, std::span<bool> valid, std::span<int> conflicts)
+    {
+        std::size_t count = grids.size() / CELL_COUNT;
+        assert(valid.size() >= count && (conflicts.empty() || conflicts.size() >= count));
+
+        std::size_t validCount = 0;
+        for (std::size_t first = 0; first < count; first += VALIDATION_LANES) {
+            std::size_t lanes = std::min<std::size_t>(VALIDATION_LANES, count - first);
+            const std::uint8_t* group = grids.data() + first * CELL_COUNT;
+
+            // The last, incomplete group is padded with empty grids
+            alignas(32) std::array<std::uint8_t, VALIDATION_LANES * CELL_COUNT> padded;
+            if (lanes < VALIDATION_LANES) {
+                padded.fill(0);
+                std::copy(group, group + lanes * CELL_COUNT, padded.begin());
+                group = padded.data();
+            }
+
+            unsigned validLanes = validate_lanes(group);
+            for (std::size_t lane = 0; lane < lanes; lane++) {
+                bool isValid = (validLanes >> lane) & 1;
+                valid[first + lane] = isValid;
+                validCount += isValid;
+
+                // Conflicts are located by the scalar path, which only the invalid grids have to take
+                if (!conflicts.empty())
+                    conflicts[first + lane] = isValid ? -1 : first_conflict(group + lane * CELL_COUNT);
+            }
+        }
+
+        return validCount;
+    }
+
+    int first_conflict(const std::uint8_t* grid)
+    {
+        std::array<CandidateMask, BOARD_SIZE> rows = {}, cols = {}, boxes = {};
+
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            CandidateMask bit = NUMBER_BITS[grid[cell]];
+            CandidateMask& row = rows[CELL_ROW[cell]];
+            CandidateMask& col = cols[CELL_COL[cell]];
+            CandidateMask& box = boxes[CELL_BOX[cell]];
+            if (bit == 0 || ((row | col | box) & bit))
+                return cell;
+
+            row |= bit;
+            col |= bit;
+            box |= bit;
+        }
+
+        return -1;
+    }
+
+}
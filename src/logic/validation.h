@@ -0,0 +1,29 @@
+#pragma once
+
+#include "candidates.h"
+#include <cstdint>
+#include <span>
+
+
+namespace Sudoku {
+
+    // --------------------
+    // Bulk grid validation
+    // --------------------
+
+    // Validates completed grids stored contiguously, CELL_COUNT bytes each (row by row, values 1-BOARD_SIZE).
+    // A grid is valid if every row, column and inner square holds every number exactly once - empty fields
+    // and values out of range make it invalid. Grids are processed in groups of VALIDATION_LANES, in a
+    // structure-of-arrays layout, so that the unit masks of the whole group are built with SIMD bit operations.
+    constexpr int VALIDATION_LANES = 16;
+
+    // Stores the result of every grid in valid (which must be at least as long as the number of grids).
+    // If conflicts is not empty (it must be as long as valid then), it receives the first conflicting cell of every
+    // invalid grid (see first_conflict()) and -1 for the valid ones. Returns the number of valid grids.
+    std::size_t validate_grids(std::span<const std::uint8_t> grids, std::span<bool> valid, std::span<int> conflicts = {});
+
+    // First cell, in row-major order, which is empty, out of range or repeats a number of an earlier cell in its row,
+    // column or inner square. Returns -1 for valid grids.
+    int first_conflict(const std::uint8_t* grid);
+
+}
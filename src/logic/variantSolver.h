@@ -0,0 +1,343 @@
+#pragma once
+
+#include "variants.h"
+#include <algorithm>
+#include <bitset>
+#include <tuple>
+
+
+namespace Sudoku {
+
+    // -------------------
+    // VariantSolver class
+    // -------------------
+
+    // Constraint propagation solver for sudoku variants. Rows and columns are always units, the other rules come from
+    // the policies (see variants.h) - the set of rules is fixed at compile time, so that no unused rule costs anything.
+    // Classic puzzles keep using Solver, which is specialized for them.
+    template <typename Regions, typename... Extras>
+    class VariantSolver
+    {
+    public:
+        VariantSolver() : VariantSolver(Regions(), Extras()...) {}
+        explicit VariantSolver(Regions regions, Extras... extras);
+
+        // Main solving methods
+        bool solve(Board& board);                               // Returns true if the board was succesfully solved
+        int countSolutions(const Board& board, int limit);      // Stops counting after reaching the limit
+        bool isSolution(const Board& board) const;              // True for a completed board satisfying all the rules
+
+        // Statistics of the last solve
+        struct Stats
+        {
+            long guesses = 0;
+            long backtracks = 0;
+        };
+
+        const Stats& getStats() const { return stats; }
+
+    private:
+        struct SearchState
+        {
+            Possibilities candidates;
+            std::bitset<CELL_COUNT> placed;
+        };
+
+        // Helper functions - setup
+        template <typename Policy>
+        void collectRules(const Policy& policy, std::vector<CellGroup>& groups);
+        // Helper functions - optional parts of the policies
+        template <typename Policy>
+        static bool isSatisfied(const Policy& policy, const Board& board);
+        template <typename Policy>
+        static bool propagate(const Policy& policy, Possibilities& candidates, bool& changed);
+        // Helper functions - solve components
+        bool run(Board& board, int limit);
+        bool assign(SearchState& state, int cell, int num);     // Places the number and propagates naked singles
+        bool propagate(SearchState& state);                     // Hidden singles and policy eliminations, until nothing changes
+        bool search(SearchState& state, int depth);
+
+        // Rules
+        Regions regions;
+        std::tuple<Extras...> extras;
+        std::vector<CellList> units;
+        std::vector<CellIndex> peers;                               // Peers of every field, one field after another (on the heap,
+        std::array<std::uint32_t, CELL_COUNT + 1> peerOffsets = {}; // as a dense table would take most of a stack on 25x25 boards)
+
+        // Search data - the arena is allocated once, with a slot for every depth
+        std::vector<SearchState> arena;
+        Board solution;
+        int solutionLimit = 1;
+        int solutionsFound = 0;
+        Stats stats;
+    };
+
+    // Available variants
+    using DiagonalSolver = VariantSolver<StandardBoxes, DiagonalConstraint>;
+    using JigsawSolver = VariantSolver<JigsawRegions>;
+    using KillerSolver = VariantSolver<StandardBoxes, KillerCages>;
+
+
+    // ------------------------------------
+    // VariantSolver methods - construction
+    // ------------------------------------
+
+    template <typename Regions, typename... Extras>
+    VariantSolver<Regions, Extras...>::VariantSolver(Regions regions, Extras... extras)
+        : regions(std::move(regions)), extras(std::move(extras)...), arena(CELL_COUNT + 1)
+    {
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            units.push_back(row_cells(i));
+            units.push_back(col_cells(i));
+        }
+
+        std::vector<CellGroup> groups;
+        collectRules(this->regions, groups);
+        std::apply([this, &groups](const auto&... policies) { (collectRules(policies, groups), ...); }, this->extras);
+
+        // Every two fields of a unit or a group are peers
+        for (const CellList& unit : units)
+            groups.emplace_back(unit.begin(), unit.end());
+
+        std::vector<std::bitset<CELL_COUNT>> isPeer(CELL_COUNT);
+        for (const CellGroup& group : groups) {
+            for (int a : group) {
+                for (int b : group) {
+                    if (a != b)
+                        isPeer[a][b] = true;
+                }
+            }
+        }
+
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            for (int other = 0; other < CELL_COUNT; other++) {
+                if (isPeer[cell][other])
+                    peers.push_back(CellIndex(other));
+            }
+            peerOffsets[cell + 1] = static_cast<std::uint32_t>(peers.size());
+        }
+    }
+
+    template <typename Regions, typename... Extras>
+    template <typename Policy>
+    void VariantSolver<Regions, Extras...>::collectRules(const Policy& policy, std::vector<CellGroup>& groups)
+    {
+        if constexpr (requires { policy.addUnits(units); })
+            policy.addUnits(units);
+        if constexpr (requires { policy.addGroups(groups); })
+            policy.addGroups(groups);
+    }
+
+    template <typename Regions, typename... Extras>
+    template <typename Policy>
+    bool VariantSolver<Regions, Extras...>::isSatisfied(const Policy& policy, const Board& board)
+    {
+        if constexpr (requires { policy.isSatisfied(board); })
+            return policy.isSatisfied(board);
+        return true;
+    }
+
+    template <typename Regions, typename... Extras>
+    template <typename Policy>
+    bool VariantSolver<Regions, Extras...>::propagate(const Policy& policy, Possibilities& candidates, bool& changed)
+    {
+        if constexpr (requires { policy.propagate(candidates, changed); })
+            return policy.propagate(candidates, changed);
+        return true;
+    }
+
+
+    // ----------------------------------
+    // VariantSolver methods - main solve
+    // ----------------------------------
+
+    template <typename Regions, typename... Extras>
+    bool VariantSolver<Regions, Extras...>::solve(Board& board)
+    {
+        return run(board, 1);
+    }
+
+    template <typename Regions, typename... Extras>
+    int VariantSolver<Regions, Extras...>::countSolutions(const Board& board, int limit)
+    {
+        Board copy = board;
+        run(copy, limit);
+
+        return solutionsFound;
+    }
+
+    template <typename Regions, typename... Extras>
+    bool VariantSolver<Regions, Extras...>::isSolution(const Board& board) const
+    {
+        for (const CellList& unit : units) {
+            CandidateMask seen = 0;
+            for (int cell : unit) {
+                if (board.isEmpty(cell))
+                    return false;
+                seen |= candidate_bit(board.getNumber(cell));
+            }
+            if (seen != ALL_CANDIDATES)
+                return false;
+        }
+
+        // Groups are covered by the peers
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            for (std::uint32_t i = peerOffsets[cell]; i < peerOffsets[cell + 1]; i++) {
+                if (board.getNumber(peers[i]) == board.getNumber(cell))
+                    return false;
+            }
+        }
+
+        return isSatisfied(regions, board) &&
+               std::apply([&board](const auto&... policies) { return (isSatisfied(policies, board) && ...); }, extras);
+    }
+
+    template <typename Regions, typename... Extras>
+    bool VariantSolver<Regions, Extras...>::run(Board& board, int limit)
+    {
+        stats = {};
+        solutionLimit = limit;
+        solutionsFound = 0;
+
+        SearchState& state = arena[0];
+        state.candidates.fill(ALL_CANDIDATES);
+        state.placed.reset();
+
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (!board.isEmpty(cell) && !assign(state, cell, board.getNumber(cell)))
+                return false;
+        }
+
+        if (!search(state, 0))
+            return false;
+
+        // Counting leaves the board intact
+        if (solutionLimit == 1)
+            board = solution;
+        return true;
+    }
+
+    template <typename Regions, typename... Extras>
+    bool VariantSolver<Regions, Extras...>::search(SearchState& state, int depth)
+    {
+        if (!propagate(state))
+            return false;
+
+        // Field with the least candidates
+        int bestCell = -1, bestKey = BOARD_SIZE + 1;
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            int key = candidate_count(state.candidates[cell]);
+            if (!state.placed[cell] && key < bestKey) {
+                bestCell = cell;
+                bestKey = key;
+            }
+        }
+
+        // All the fields are placed
+        if (bestCell < 0) {
+            for (int cell = 0; cell < CELL_COUNT; cell++)
+                solution.setNumber(cell, lowest_candidate(state.candidates[cell]));
+            return ++solutionsFound >= solutionLimit;
+        }
+
+        SearchState& next = arena[depth + 1];
+        for (CandidateMask options = state.candidates[bestCell]; options != 0; options &= options - 1) {
+            stats.guesses++;
+            next = state;
+            if (assign(next, bestCell, lowest_candidate(options)) && search(next, depth + 1))
+                return true;
+            stats.backtracks++;
+        }
+
+        return false;
+    }
+
+
+    // -----------------------------------
+    // VariantSolver methods - propagation
+    // -----------------------------------
+
+    template <typename Regions, typename... Extras>
+    bool VariantSolver<Regions, Extras...>::assign(SearchState& state, int cell, int num)
+    {
+        if (!(state.candidates[cell] & candidate_bit(num)))
+            return false;
+
+        // Fields becoming naked singles are placed in turn
+        std::array<CellIndex, CELL_COUNT> pending;
+        int pendingCount = 0;
+
+        state.candidates[cell] = candidate_bit(num);
+        pending[pendingCount++] = CellIndex(cell);
+
+        while (pendingCount > 0) {
+            int current = pending[--pendingCount];
+            if (state.placed[current])
+                continue;
+            state.placed[current] = true;
+
+            CandidateMask bit = state.candidates[current];
+            for (std::uint32_t i = peerOffsets[current]; i < peerOffsets[current + 1]; i++) {
+                int peer = peers[i];
+                CandidateMask& options = state.candidates[peer];
+                if (!(options & bit))
+                    continue;
+
+                options &= ~bit;
+                if (options == 0)
+                    return false;
+                if (candidate_count(options) == 1 && !state.placed[peer] && pendingCount < CELL_COUNT)
+                    pending[pendingCount++] = CellIndex(peer);
+            }
+        }
+
+        return true;
+    }
+
+    template <typename Regions, typename... Extras>
+    bool VariantSolver<Regions, Extras...>::propagate(SearchState& state)
+    {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+
+            // Hidden singles - a number with only one place left in a unit
+            for (const CellList& unit : units) {
+                CandidateMask once = 0, twice = 0;
+                for (int cell : unit) {
+                    twice |= once & state.candidates[cell];
+                    once |= state.candidates[cell];
+                }
+                if (once != ALL_CANDIDATES)
+                    return false;
+
+                CandidateMask hidden = once & ~twice;
+                for (int cell : unit) {
+                    CandidateMask single = state.candidates[cell] & hidden;
+                    if (single == 0 || state.placed[cell])
+                        continue;
+                    if (candidate_count(single) > 1 || !assign(state, cell, lowest_candidate(single)))
+                        return false;
+                    changed = true;
+                }
+            }
+
+            // Eliminations of the policies, which can leave new naked singles behind
+            bool eliminated = false;
+            if (!propagate(regions, state.candidates, eliminated) ||
+                !std::apply([&](const auto&... policies) { return (propagate(policies, state.candidates, eliminated) && ...); }, extras))
+                return false;
+            if (eliminated) {
+                changed = true;
+                for (int cell = 0; cell < CELL_COUNT; cell++) {
+                    if (!state.placed[cell] && candidate_count(state.candidates[cell]) == 1 &&
+                        !assign(state, cell, lowest_candidate(state.candidates[cell])))
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+}
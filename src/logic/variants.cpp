@@ -0,0 +1,245 @@
+#include "variants.h"
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <stdexcept>
+
+
+namespace Sudoku {
+
+    // Customizable parameters
+    constexpr int MAX_RANDOM_CAGE_SIZE = 5;
+    constexpr int JIGSAW_SWAPS = 40;        // Attempted exchanges of fields between regions of a random layout
+
+
+    // ----------------
+    // Helper functions
+    // ----------------
+
+    // Appends all the sets of count distinct numbers (not smaller than first) with the given sum
+    // Enumerated recursively instead of over all the masks, which would be too many on 25x25 boards
+    static void collect_combinations(int first, int count, int sum, CandidateMask mask, std::vector<CandidateMask>& combinations)
+    {
+        if (count == 0) {
+            if (sum == 0)
+                combinations.push_back(mask);
+            return;
+        }
+
+        // The remaining numbers sum up to at least first + (first + 1) + ...
+        for (int num = first; num <= BOARD_SIZE && count * num + count * (count - 1) / 2 <= sum; num++)
+            collect_combinations(num + 1, count - 1, sum - num, mask | candidate_bit(num), combinations);
+    }
+
+
+    // -----------------------
+    // Region policies (boxes)
+    // -----------------------
+
+    void StandardBoxes::addUnits(std::vector<CellList>& units) const
+    {
+        for (int box = 0; box < BOARD_SIZE; box++)
+            units.push_back(box_cells(box));
+    }
+
+    JigsawRegions::JigsawRegions()
+        : JigsawRegions(CELL_BOX)
+    {
+    }
+
+    JigsawRegions::JigsawRegions(const std::array<std::uint8_t, CELL_COUNT>& cellRegions)
+        : cellRegions(cellRegions)
+    {
+        std::array<int, BOARD_SIZE> sizes = {};
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            int region = cellRegions[cell];
+            if (region >= BOARD_SIZE || sizes[region] == BOARD_SIZE)
+                throw std::invalid_argument("every region must contain exactly " + std::to_string(BOARD_SIZE) + " fields");
+            regions[region][sizes[region]++] = CellIndex(cell);
+        }
+    }
+
+    JigsawRegions JigsawRegions::parse(const std::string& layout)
+    {
+        if (layout.size() != CELL_COUNT)
+            throw std::invalid_argument("layout must contain " + std::to_string(CELL_COUNT) + " symbols");
+
+        std::array<std::uint8_t, CELL_COUNT> cellRegions;
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            int region = symbol_number(layout[cell]);
+            if (region == 0)
+                throw std::invalid_argument(std::string("invalid region symbol '") + layout[cell] + "'");
+            cellRegions[cell] = std::uint8_t(region - 1);
+        }
+
+        return JigsawRegions(cellRegions);
+    }
+
+    std::string JigsawRegions::toString() const
+    {
+        std::string result(CELL_COUNT, ' ');
+        for (int cell = 0; cell < CELL_COUNT; cell++)
+            result[cell] = number_symbol(cellRegions[cell] + 1);
+
+        return result;
+    }
+
+    void JigsawRegions::addUnits(std::vector<CellList>& units) const
+    {
+        units.insert(units.end(), regions.begin(), regions.end());
+    }
+
+
+    // -----------------
+    // Extra constraints
+    // -----------------
+
+    void DiagonalConstraint::addUnits(std::vector<CellList>& units) const
+    {
+        CellList main, anti;
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            main[i] = CellIndex(cell_index(i, i));
+            anti[i] = CellIndex(cell_index(i, BOARD_SIZE - 1 - i));
+        }
+
+        units.push_back(main);
+        units.push_back(anti);
+    }
+
+    KillerCages::KillerCages(std::vector<Cage> cages)
+        : cages(std::move(cages))
+    {
+        std::array<bool, CELL_COUNT> covered = {};
+
+        for (const Cage& cage : this->cages) {
+            if (cage.cells.empty() || cage.cells.size() > BOARD_SIZE)
+                throw std::invalid_argument("cage size out of range");
+            for (int cell : cage.cells) {
+                if (cell >= CELL_COUNT || covered[cell])
+                    throw std::invalid_argument("cages must not overlap");
+                covered[cell] = true;
+            }
+
+            std::vector<CandidateMask> cageCombinations;
+            collect_combinations(1, static_cast<int>(cage.cells.size()), cage.sum, 0, cageCombinations);
+
+            if (cageCombinations.empty())
+                throw std::invalid_argument("impossible cage sum " + std::to_string(cage.sum));
+            combinations.push_back(std::move(cageCombinations));
+        }
+    }
+
+    void KillerCages::addGroups(std::vector<CellGroup>& groups) const
+    {
+        for (const Cage& cage : cages)
+            groups.push_back(cage.cells);
+    }
+
+    bool KillerCages::propagate(Possibilities& candidates, bool& changed) const
+    {
+        for (std::size_t i = 0; i < cages.size(); i++) {
+            const CellGroup& cells = cages[i].cells;
+
+            CandidateMask available = 0;
+            for (int cell : cells)
+                available |= candidates[cell];
+
+            // A combination is feasible if its numbers are available and every field can take one of them
+            CandidateMask allowed = 0;
+            for (CandidateMask combination : combinations[i]) {
+                if ((combination & ~available) == 0 &&
+                    std::all_of(cells.begin(), cells.end(), [&](int cell) { return candidates[cell] & combination; }))
+                    allowed |= combination;
+            }
+
+            for (int cell : cells) {
+                CandidateMask reduced = candidates[cell] & allowed;
+                if (reduced == 0)
+                    return false;
+                if (reduced != candidates[cell]) {
+                    candidates[cell] = reduced;
+                    changed = true;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool KillerCages::isSatisfied(const Board& board) const
+    {
+        return std::all_of(cages.begin(), cages.end(), [&board](const Cage& cage) {
+            int sum = 0;
+            for (int cell : cage.cells)
+                sum += board.getNumber(cell);
+            return sum == cage.sum;
+        });
+    }
+
+
+    // ----------------------
+    // Random variant puzzles
+    // ----------------------
+
+    JigsawRegions random_jigsaw_regions(const Board& solution, RandomStream& randomGen)
+    {
+        // Exchanging two fields with the same number between regions keeps every number in every region
+        std::array<std::uint8_t, CELL_COUNT> cellRegions = CELL_BOX;
+
+        for (int i = 0; i < JIGSAW_SWAPS; i++) {
+            int a = randomGen.below(CELL_COUNT), b = randomGen.below(CELL_COUNT);
+            if (cellRegions[a] != cellRegions[b] && solution.getNumber(a) == solution.getNumber(b))
+                std::swap(cellRegions[a], cellRegions[b]);
+        }
+
+        return JigsawRegions(cellRegions);
+    }
+
+    KillerCages random_killer_cages(const Board& solution, RandomStream& randomGen)
+    {
+        std::array<bool, CELL_COUNT> covered = {};
+        std::vector<int> order(CELL_COUNT);
+        std::iota(order.begin(), order.end(), 0);
+        randomGen.shuffle(order.begin(), order.end());
+
+        std::vector<Cage> cages;
+
+        for (int start : order) {
+            if (covered[start])
+                continue;
+
+            // Grow the cage through random neighbours, without repeating numbers
+            Cage cage = { { CellIndex(start) }, solution.getNumber(start) };
+            CandidateMask used = candidate_bit(solution.getNumber(start));
+            covered[start] = true;
+
+            for (int size = randomGen.between(1, MAX_RANDOM_CAGE_SIZE); static_cast<int>(cage.cells.size()) < size;) {
+                std::vector<int> neighbours;
+                for (int cell : cage.cells) {
+                    int row = CELL_ROW[cell], col = CELL_COL[cell];
+                    for (auto [dr, dc] : { std::pair{-1, 0}, std::pair{1, 0}, std::pair{0, -1}, std::pair{0, 1} }) {
+                        int r = row + dr, c = col + dc;
+                        if (r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE)
+                            continue;
+                        int neighbour = cell_index(r, c);
+                        if (!covered[neighbour] && !(used & candidate_bit(solution.getNumber(neighbour))))
+                            neighbours.push_back(neighbour);
+                    }
+                }
+                if (neighbours.empty())
+                    break;
+
+                int next = neighbours[randomGen.below(static_cast<int>(neighbours.size()))];
+                cage.cells.push_back(CellIndex(next));
+                cage.sum += solution.getNumber(next);
+                used |= candidate_bit(solution.getNumber(next));
+                covered[next] = true;
+            }
+
+            cages.push_back(std::move(cage));
+        }
+
+        return KillerCages(std::move(cages));
+    }
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "candidates.h"
+#include "random.h"
+#include <string>
+#include <vector>
+
+
+namespace Sudoku {
+
+    // --------------
+    // Helper defines
+    // --------------
+
+    // Variant rules are described by constraint policies, combined at compile time by VariantSolver.
+    // A policy can provide any of the following:
+    //  - void addUnits(std::vector<CellList>& units) const            - groups of BOARD_SIZE fields containing every number once
+    //  - void addGroups(std::vector<CellGroup>& groups) const         - groups of fields containing different numbers
+    //  - bool propagate(Possibilities& candidates, bool& changed) const  - additional eliminations, false on contradiction
+    //  - bool isSatisfied(const Board& board) const                   - final check of a completed board
+
+    using CellGroup = std::vector<CellIndex>;
+
+
+    // -----------------------
+    // Region policies (boxes)
+    // -----------------------
+
+    // Classic inner squares
+    struct StandardBoxes
+    {
+        void addUnits(std::vector<CellList>& units) const;
+    };
+
+    // Irregular regions of BOARD_SIZE fields each (jigsaw sudoku)
+    class JigsawRegions
+    {
+    public:
+        JigsawRegions();                                                    // Classic inner squares as regions
+        explicit JigsawRegions(const std::array<std::uint8_t, CELL_COUNT>& cellRegions);   // Throws std::invalid_argument for invalid layouts
+
+        // Layout given as a single line of region symbols ('1' - '9'), one per field
+        static JigsawRegions parse(const std::string& layout);
+        std::string toString() const;
+
+        void addUnits(std::vector<CellList>& units) const;
+        int region(int cell) const { return cellRegions[cell]; }
+
+    private:
+        std::array<std::uint8_t, CELL_COUNT> cellRegions;
+        std::array<CellList, BOARD_SIZE> regions;
+    };
+
+
+    // -----------------
+    // Extra constraints
+    // -----------------
+
+    // Both main diagonals contain every number once (sudoku X)
+    struct DiagonalConstraint
+    {
+        void addUnits(std::vector<CellList>& units) const;
+    };
+
+    // Cages of fields with distinct numbers adding up to the given sum (killer sudoku)
+    struct Cage
+    {
+        CellGroup cells;
+        int sum;
+    };
+
+    class KillerCages
+    {
+    public:
+        KillerCages() = default;
+        explicit KillerCages(std::vector<Cage> cages);      // Throws std::invalid_argument for overlapping cages or impossible sums
+
+        void addGroups(std::vector<CellGroup>& groups) const;
+        bool propagate(Possibilities& candidates, bool& changed) const;     // Removes candidates not used by any feasible sum
+        bool isSatisfied(const Board& board) const;
+
+        const std::vector<Cage>& getCages() const { return cages; }
+
+    private:
+        std::vector<Cage> cages;
+        std::vector<std::vector<CandidateMask>> combinations;     // Sets of numbers which sum up correctly, for every cage
+    };
+
+
+    // ----------------------
+    // Random variant puzzles
+    // ----------------------
+
+    // Both derive the variant from a solved classic board, which remains a valid solution
+    JigsawRegions random_jigsaw_regions(const Board& solution, RandomStream& randomGen);
+    KillerCages random_killer_cages(const Board& solution, RandomStream& randomGen);
+
+}
@@ -0,0 +1,417 @@
+#include "../bench/corpus.h"
+#include "../logic/generators.h"
+#include "../logic/laneSolver.h"
+#include "../logic/satSolver.h"
+#include "../logic/solutionEnumerator.h"
+#include "../logic/variantSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace Sudoku;
+
+
+// -----------------------
+// Customizable parameters
+// -----------------------
+
+// Bigger boards are verified by the dedicated builds (sudoku-verify-16, sudoku-verify-25)
+constexpr bool LARGE_BOARD = BOARD_SIZE > 9;
+
+constexpr std::size_t DEFAULT_PUZZLE_COUNT = BOARD_SIZE == 9 ? 1000 : BOARD_SIZE == 16 ? 100 : 20;
+constexpr std::size_t MUTATED_SET_RATIO = 4;        // Ambiguous and broken sets have count / MUTATED_SET_RATIO puzzles
+constexpr int AMBIGUOUS_REMOVED_CELLS = BOARD_SIZE / 3;     // Givens removed from unique puzzles to make them ambiguous
+constexpr int COUNT_LIMIT = 4;                      // Solution counts are compared up to this limit
+constexpr long SEARCH_BACKTRACK_LIMIT = LARGE_BOARD ? 20000 : 0;   // Search backends are bounded on the bigger boards
+
+// Regressions are kept in the source tree (one file per board size), so that every build directory shares them
+#ifndef SUDOKU_SOURCE_DIR
+#define SUDOKU_SOURCE_DIR "."
+#endif
+const std::string DEFAULT_REGRESSION_FILE = std::string(SUDOKU_SOURCE_DIR) + "/sudoku-regressions" +
+                                            (BOARD_SIZE == 9 ? "" : "-" + std::to_string(BOARD_SIZE)) + ".txt";
+
+// Time budget of every backend on every corpus (solving and counting together), in seconds
+const std::map<std::string, double> DEFAULT_BUDGETS = {
+    { "random", LARGE_BOARD ? 10.0 : 2.0 },
+    { "ambiguous", LARGE_BOARD ? 10.0 : 2.0 },
+    { "broken", LARGE_BOARD ? 10.0 : 2.0 },
+    { "hard", 5.0 },
+    { "regressions", 10.0 },
+    { "file", 60.0 },
+};
+
+
+// --------------
+// Helper defines
+// --------------
+
+struct Corpus
+{
+    std::string name;
+    std::vector<Board> puzzles;
+};
+
+// Solving backend under verification - the first one is the reference for the others
+struct Backend
+{
+    std::string name;
+    std::function<void(std::span<Board> boards, std::span<bool> solved)> solve;
+    std::function<int(const Board& board, int limit)> count;    // Empty for backends which cannot count solutions
+    bool bounded = false;       // Bounded backends may give up a puzzle, so their failures are inconclusive
+};
+
+// Outcome of a single backend on a single puzzle
+struct Outcome
+{
+    bool solved = false;
+    Board solution;
+    int solutions = -1;         // -1 if not counted
+};
+
+
+// ----------------
+// Helper functions
+// ----------------
+
+void print_usage()
+{
+    std::cerr << "Usage: sudoku-verify [--count <n>] [--seed <n>] [--file <path>] [--regressions <path>] [--budget <corpus>=<seconds>]\n"
+                 "Runs generated, mutated and stored puzzles through every solving backend and compares the results.\n"
+                 "Failing puzzles are minimized and appended to the regressions file, which is verified on every run\n"
+                 "(by default " << DEFAULT_REGRESSION_FILE << ").\n"
+                 "Corpora: random, ambiguous, broken, hard, regressions, file\n";
+}
+
+// Per-puzzle backends, which share the same interface
+template <typename AnySolver>
+Backend one_by_one(std::string name, AnySolver& solver, bool bounded = false)
+{
+    return {
+        std::move(name),
+        [&solver](std::span<Board> boards, std::span<bool> solved) {
+            for (std::size_t i = 0; i < boards.size(); i++)
+                solved[i] = solver.solve(boards[i]);
+        },
+        [&solver](const Board& board, int limit) { return solver.countSolutions(board, limit); },
+        bounded
+    };
+}
+
+// Ambiguous puzzles - unique ones with a few givens removed
+Board remove_givens(Board puzzle, int count, RandomStream& randomGen)
+{
+    std::vector<int> givens;
+    for (int cell = 0; cell < CELL_COUNT; cell++) {
+        if (!puzzle.isEmpty(cell))
+            givens.push_back(cell);
+    }
+    randomGen.shuffle(givens.begin(), givens.end());
+
+    for (int i = 0; i < count && i < static_cast<int>(givens.size()); i++)
+        puzzle.setNumber(givens[i], 0);
+    return puzzle;
+}
+
+// Broken puzzles - one given replaced with another number not present among its peers, which usually leaves no solution
+Board replace_given(Board puzzle, RandomStream& randomGen)
+{
+    std::vector<int> givens;
+    for (int cell = 0; cell < CELL_COUNT; cell++) {
+        if (!puzzle.isEmpty(cell))
+            givens.push_back(cell);
+    }
+    randomGen.shuffle(givens.begin(), givens.end());
+
+    for (int cell : givens) {
+        CandidateMask used = candidate_bit(puzzle.getNumber(cell));
+        for (int peer : CELL_PEERS[cell]) {
+            if (!puzzle.isEmpty(peer))
+                used |= candidate_bit(puzzle.getNumber(peer));
+        }
+        if (CandidateMask free = ALL_CANDIDATES & ~used; free != 0) {
+            puzzle.setNumber(cell, lowest_candidate(free));
+            break;
+        }
+    }
+
+    return puzzle;
+}
+
+std::vector<Corpus> build_corpora(std::size_t count, RandomStream& randomGen)
+{
+    Solver solver;
+    PositionGenerator generator(&solver);
+
+    Corpus random = { "random", std::vector<Board>(count) };
+    for (Board& puzzle : random.puzzles)
+        generator.generate(puzzle, randomGen);
+
+    Corpus ambiguous = { "ambiguous", {} }, broken = { "broken", {} };
+    for (std::size_t i = 0; i < std::max<std::size_t>(count / MUTATED_SET_RATIO, 1) && i < count; i++) {
+        ambiguous.puzzles.push_back(remove_givens(random.puzzles[i], AMBIGUOUS_REMOVED_CELLS, randomGen));
+        broken.puzzles.push_back(replace_given(random.puzzles[i], randomGen));
+    }
+
+    std::vector<Corpus> corpora = { std::move(random), std::move(ambiguous), std::move(broken) };
+    if (!LARGE_BOARD) {
+        Corpus& hard = corpora.emplace_back(Corpus{ "hard", {} });
+        for (const char* setup : HARD_PUZZLES) {
+            hard.puzzles.emplace_back();
+            hard.puzzles.back().load(setup);
+        }
+    }
+
+    return corpora;
+}
+
+// Compares the outcomes of the backends on the puzzle with the reference (the first one)
+// Returns the description of the first discrepancy found and sets blamed to its backend, or returns an empty string
+std::string find_discrepancy(const Board& puzzle, const std::vector<const Backend*>& backends, const std::vector<Outcome>& outcomes,
+                             std::size_t& blamed)
+{
+    const Outcome& reference = outcomes[0];
+    blamed = 0;
+    if (reference.solutions != -1 && (reference.solutions > 0) != reference.solved)
+        return "solution count contradicts the solve";
+
+    for (blamed = 0; blamed < backends.size(); blamed++) {
+        const Outcome& outcome = outcomes[blamed];
+        bool bounded = backends[blamed]->bounded;
+
+        // Bounded backends may give up, but they can neither find nonexistent solutions nor overcount
+        if (outcome.solved && !is_solution(puzzle, outcome.solution))
+            return "incorrect solution";
+        if (outcome.solved != reference.solved && !(bounded && !outcome.solved))
+            return outcome.solved ? "solved an unsolvable puzzle" : "missed a solution";
+        if (outcome.solutions != -1 && outcome.solutions != reference.solutions && !(bounded && outcome.solutions < reference.solutions))
+            return "counted " + std::to_string(outcome.solutions) + " solutions instead of " + std::to_string(reference.solutions);
+        if (reference.solutions == 1 && outcome.solved && outcome.solution.toString() != reference.solution.toString())
+            return "different unique solution";
+    }
+
+    return {};
+}
+
+std::string verify_puzzle(const Board& puzzle, const std::vector<const Backend*>& backends)
+{
+    std::vector<Outcome> outcomes(backends.size());
+    for (std::size_t b = 0; b < backends.size(); b++) {
+        outcomes[b].solution = puzzle;
+        backends[b]->solve(std::span<Board>(&outcomes[b].solution, 1), std::span<bool>(&outcomes[b].solved, 1));
+        if (backends[b]->count)
+            outcomes[b].solutions = backends[b]->count(puzzle, COUNT_LIMIT);
+    }
+
+    std::size_t blamed;
+    return find_discrepancy(puzzle, backends, outcomes, blamed);
+}
+
+// Greedily removes the givens for as long as the discrepancy between the reference and the failing backend persists
+Board minimize(Board puzzle, const Backend& reference, const Backend& failing)
+{
+    std::vector<const Backend*> pair = { &reference, &failing };
+    for (bool reduced = true; reduced;) {
+        reduced = false;
+        for (int cell = 0; cell < CELL_COUNT; cell++) {
+            if (puzzle.isEmpty(cell))
+                continue;
+
+            Board candidate = puzzle;
+            candidate.setNumber(cell, 0);
+            if (!verify_puzzle(candidate, pair).empty()) {
+                puzzle = candidate;
+                reduced = true;
+            }
+        }
+    }
+
+    return puzzle;
+}
+
+// Runs the whole corpus through every backend, timing them, and reports the puzzles with discrepancies
+// Returns the failing puzzles (not minimized yet) together with the index of the backend to blame
+std::vector<std::pair<Board, std::size_t>> verify_corpus(const Corpus& corpus, const std::vector<Backend>& backends,
+                                                         double budget, bool& withinBudget)
+{
+    std::vector<std::vector<Outcome>> outcomes(corpus.puzzles.size(), std::vector<Outcome>(backends.size()));
+    std::vector<const Backend*> backendList;
+    for (const Backend& backend : backends)
+        backendList.push_back(&backend);
+
+    for (std::size_t b = 0; b < backends.size(); b++) {
+        std::vector<Board> boards = corpus.puzzles;
+        auto solved = std::make_unique<bool[]>(boards.size());
+
+        // Batched, so that backends like the lane solver are timed on their usual workload
+        auto start = std::chrono::steady_clock::now();
+        backends[b].solve(boards, std::span<bool>(solved.get(), boards.size()));
+        for (std::size_t i = 0; i < boards.size(); i++) {
+            outcomes[i][b] = { solved[i], boards[i], -1 };
+            if (backends[b].count)
+                outcomes[i][b].solutions = backends[b].count(corpus.puzzles[i], COUNT_LIMIT);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        bool overBudget = elapsed.count() > budget;
+        withinBudget &= !overBudget;
+        std::cout << std::left << std::setw(28) << corpus.name + "/" + backends[b].name << std::right
+                  << std::setw(10) << std::fixed << std::setprecision(3) << elapsed.count() << " s"
+                  << std::setw(10) << std::setprecision(1) << budget << " s budget" << (overBudget ? "  EXCEEDED" : "") << "\n";
+    }
+
+    std::vector<std::pair<Board, std::size_t>> failures;
+    for (std::size_t i = 0; i < corpus.puzzles.size(); i++) {
+        std::size_t blamed;
+        std::string discrepancy = find_discrepancy(corpus.puzzles[i], backendList, outcomes[i], blamed);
+        if (discrepancy.empty())
+            continue;
+
+        std::cout << corpus.name << "/" << backends[blamed].name << ": " << discrepancy << " on " << corpus.puzzles[i].toString() << "\n";
+        failures.emplace_back(corpus.puzzles[i], blamed);
+    }
+
+    return failures;
+}
+
+
+// ------------
+// Verification
+// ------------
+
+int main(int argc, char** argv)
+{
+    std::size_t count = DEFAULT_PUZZLE_COUNT;
+    std::uint64_t seed = random_seed();
+    std::string path, regressionPath = DEFAULT_REGRESSION_FILE;
+    std::map<std::string, double> budgets = DEFAULT_BUDGETS;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--count" && i + 1 < argc)
+            count = static_cast<std::size_t>(std::atol(argv[++i]));
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--file" && i + 1 < argc)
+            path = argv[++i];
+        else if (arg == "--regressions" && i + 1 < argc)
+            regressionPath = argv[++i];
+        else if (arg == "--budget" && i + 1 < argc && std::string(argv[i + 1]).find('=') != std::string::npos &&
+                 budgets.count(std::string(argv[i + 1]).substr(0, std::string(argv[i + 1]).find('=')))) {
+            std::string value = argv[++i];
+            std::size_t separator = value.find('=');
+            budgets[value.substr(0, separator)] = std::atof(value.c_str() + separator + 1);
+        }
+        else {
+            print_usage();
+            return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    RandomStream randomGen(seed);
+    std::vector<Corpus> corpora = build_corpora(count, randomGen);
+    try {
+        if (!path.empty())
+            corpora.push_back({ "file", read_puzzles(path) });
+        if (std::ifstream(regressionPath))
+            corpora.push_back({ "regressions", read_puzzles(regressionPath) });
+    }
+    catch (const std::exception& e) {
+        std::cerr << "sudoku-verify: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The reference is the scalar solver - or the SAT backend on the bigger boards, where the search is bounded
+    Solver solver;
+    LaneSolver laneSolver(&solver);
+    VariantSolver<StandardBoxes> classicSolver;
+    SatSolver satSolver;
+    SolutionEnumerator enumerator;
+    solver.setBacktrackLimit(SEARCH_BACKTRACK_LIMIT);
+
+    std::vector<Backend> backends;
+    if (LARGE_BOARD)
+        backends.push_back(one_by_one("sat", satSolver));
+    backends.push_back(one_by_one("scalar", solver, LARGE_BOARD));
+    backends.push_back({ "lanes", [&laneSolver](std::span<Board> boards, std::span<bool> solved) { laneSolver.solve(boards, solved); },
+                         {}, LARGE_BOARD });
+    if (!LARGE_BOARD) {
+        backends.push_back(one_by_one("variant/classic", classicSolver));
+        backends.push_back(one_by_one("sat", satSolver));
+
+        // The first solution of the stream, and the length of the stream cut at the limit
+        backends.push_back({ "enumerator",
+                             [&enumerator](std::span<Board> boards, std::span<bool> solved) {
+                                 for (std::size_t i = 0; i < boards.size(); i++) {
+                                     solved[i] = false;
+                                     for (const Board& solution : enumerator.solutions(boards[i], 0, 1)) {
+                                         boards[i] = solution;
+                                         solved[i] = true;
+                                     }
+                                 }
+                             },
+                             [&enumerator](const Board& board, int limit) {
+                                 int count = 0;
+                                 for ([[maybe_unused]] const Board& solution : enumerator.solutions(board, 0, limit))
+                                     count++;
+                                 return count;
+                             } });
+    }
+
+    std::vector<std::unique_ptr<BranchingHeuristic>> heuristics;
+    std::vector<std::unique_ptr<Solver>> heuristicSolvers;
+    for (HeuristicType type : { HeuristicType::MRV_DEGREE, HeuristicType::LCV, HeuristicType::RANDOM_RESTARTS, HeuristicType::ADAPTIVE }) {
+        heuristics.push_back(make_heuristic(type));
+        heuristicSolvers.push_back(std::make_unique<Solver>());
+        heuristicSolvers.back()->setHeuristic(heuristics.back().get());
+        heuristicSolvers.back()->setBacktrackLimit(SEARCH_BACKTRACK_LIMIT);
+        backends.push_back(one_by_one(std::string("scalar/") + heuristic_name(type), *heuristicSolvers.back(), LARGE_BOARD));
+    }
+
+    std::cout << BOARD_SIZE << "x" << BOARD_SIZE << " boards, seed " << seed << ", " << backends.size() << " backends\n";
+    bool withinBudget = true;
+    std::vector<std::pair<Board, std::size_t>> failures;
+    for (const Corpus& corpus : corpora) {
+        auto corpusFailures = verify_corpus(corpus, backends, budgets.at(corpus.name), withinBudget);
+        failures.insert(failures.end(), corpusFailures.begin(), corpusFailures.end());
+    }
+
+    // Minimized failures become regression cases, verified on every following run until fixed
+    if (!failures.empty()) {
+        std::vector<std::string> known;
+        if (std::ifstream(regressionPath)) {
+            for (const Board& puzzle : read_puzzles(regressionPath))
+                known.push_back(puzzle.toString());
+        }
+
+        std::ofstream regressions(regressionPath, std::ios::app);
+        for (const auto& [puzzle, backend] : failures) {
+            std::string minimized = minimize(puzzle, backends[0], backends[backend]).toString();
+            if (std::find(known.begin(), known.end(), minimized) != known.end())
+                continue;
+            regressions << minimized << "\n";
+            known.push_back(minimized);
+            std::cout << "regression (" << backends[backend].name << "): " << minimized << "\n";
+        }
+
+        std::cerr << "sudoku-verify: " << failures.size() << " puzzles with discrepancies, saved to " << regressionPath << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!withinBudget) {
+        std::cerr << "sudoku-verify: time budget exceeded" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "all backends agree\n";
+    return EXIT_SUCCESS;
+}